@@ -0,0 +1,76 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// E256 firmware on the Linux host : runs main.ino setup() & loop() on the replay or synthetic frames
+// Usage : e256_host [-n frames] [-r record.e256] [frames.e256]
+//   -n frames       : stop after this many frames (needed with the synthetic source)
+//   -r record.e256  : record the processed raw frames in the replay format (see source.h)
+//   frames.e256     : replay file (FRAME_SOURCE_REPLAY), the replay stop at the end of the file
+// Each frame with live tracks prints its time & the tracks UID, state, position & depth
+
+#include "main.ino"
+
+static void record_frame(FILE* file, image_t* inputFrame_ptr) {
+  uint8_t header[sizeof(uint32_t)] = {
+    (uint8_t)frameTime, (uint8_t)(frameTime >> 8), (uint8_t)(frameTime >> 16), (uint8_t)(frameTime >> 24)
+  };
+  fwrite(header, sizeof(header), 1, file);
+  fwrite(inputFrame_ptr->pData, RAW_FRAME, 1, file);
+}
+
+static void print_tracks(tracks_t* tracks_ptr) {
+  if (tracks_ptr->liveMask == 0) return;
+  printf("%u", frameTime);
+  for (uint64_t mask = tracks_ptr->liveMask; mask != 0; mask &= mask - 1) {
+    uint8_t id = __builtin_ctzll(mask);
+    printf("\t%d:%d:%.2f:%.2f:%d", id, TRACK_GET_STATE(tracks_ptr, id), tracks_ptr->X[id], tracks_ptr->Y[id], tracks_ptr->D[id]);
+  }
+  printf("\n");
+}
+
+int main(int argc, char** argv) {
+  long maxFrames = -1;
+  FILE* recordFile = NULL;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+      maxFrames = atol(argv[++i]);
+    }
+    else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+      recordFile = fopen(argv[++i], "wb");
+      if (recordFile == NULL) {
+        fprintf(stderr, "e256_host: can't create %s\n", argv[i]);
+        return 1;
+      }
+    }
+    else {
+#if FRAME_SOURCE == FRAME_SOURCE_REPLAY
+      replayPath = argv[i];
+#endif
+    }
+  }
+
+  setup();
+#if FRAME_SOURCE == FRAME_SOURCE_REPLAY
+  if (replayFile == NULL) {
+    fprintf(stderr, "e256_host: can't open %s\n", replayPath);
+    return 1;
+  }
+#endif
+
+  long frames = 0;
+  while (maxFrames < 0 || frames < maxFrames) {
+    loop();
+#if FRAME_SOURCE == FRAME_SOURCE_REPLAY
+    if (replayFile == NULL) break;        // End of the replay file
+#endif
+    if (recordFile != NULL) record_frame(recordFile, &rawFrame);
+    print_tracks(&tracks);
+    frames++;
+  }
+  if (recordFile != NULL) fclose(recordFile);
+  fprintf(stderr, "e256_host: %ld frames\n", frames);
+  return 0;
+}
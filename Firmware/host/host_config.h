@@ -0,0 +1,88 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Linux host build overrides, included at the end of config.h when E256_HOST is defined
+// The USB & hardware outputs are not available on the host, the frames come from the replay or synthetic sources
+// Each test can select its own settings with HOST_<SETTING> compile definitions (see CMakeLists.txt)
+
+#ifndef __HOST_CONFIG_H__
+#define __HOST_CONFIG_H__
+
+#undef USB_MIDI
+#define USB_MIDI            0
+#undef USB_SLIP_OSC
+#define USB_SLIP_OSC        0
+#undef HARDWARE_MIDI
+#define HARDWARE_MIDI       0
+#undef MAPPING_LAYAOUT
+#define MAPPING_LAYAOUT     0
+
+#undef FRAME_SOURCE
+#ifdef HOST_FRAME_SOURCE
+#define FRAME_SOURCE        HOST_FRAME_SOURCE
+#else
+#define FRAME_SOURCE        FRAME_SOURCE_REPLAY
+#endif
+#define REPLAY_LOOP         0
+
+#ifdef HOST_INTERP_KERNEL
+#undef INTERP_KERNEL
+#define INTERP_KERNEL       HOST_INTERP_KERNEL
+#endif
+#ifdef HOST_INTERP_DIRTY_TILES
+#undef INTERP_DIRTY_TILES
+#define INTERP_DIRTY_TILES  HOST_INTERP_DIRTY_TILES
+#endif
+#ifdef HOST_BLOB_LABELLER
+#undef BLOB_LABELLER
+#define BLOB_LABELLER       HOST_BLOB_LABELLER
+#endif
+#ifdef HOST_BLOB_SPLIT
+#undef BLOB_SPLIT
+#define BLOB_SPLIT          HOST_BLOB_SPLIT
+#endif
+#ifdef HOST_BLOB_LINEAGE
+#undef BLOB_LINEAGE
+#define BLOB_LINEAGE        HOST_BLOB_LINEAGE
+#endif
+#ifdef HOST_BLOB_HYSTERESIS
+#undef BLOB_HYSTERESIS
+#define BLOB_HYSTERESIS     HOST_BLOB_HYSTERESIS
+#endif
+#ifdef HOST_BLOB_BIRTH_FRAMES
+#undef BLOB_BIRTH_FRAMES
+#define BLOB_BIRTH_FRAMES   HOST_BLOB_BIRTH_FRAMES
+#endif
+#ifdef HOST_BLOB_DEATH_FRAMES
+#undef BLOB_DEATH_FRAMES
+#define BLOB_DEATH_FRAMES   HOST_BLOB_DEATH_FRAMES
+#endif
+#ifdef HOST_BLOB_ASSIGNMENT_MAX
+#undef BLOB_ASSIGNMENT_MAX
+#define BLOB_ASSIGNMENT_MAX HOST_BLOB_ASSIGNMENT_MAX
+#endif
+#ifdef HOST_BLOB_PREDICTION
+#undef BLOB_PREDICTION
+#define BLOB_PREDICTION     HOST_BLOB_PREDICTION
+#endif
+#ifdef HOST_BASELINE_TRACKING
+#undef BASELINE_TRACKING
+#define BASELINE_TRACKING   HOST_BASELINE_TRACKING
+#endif
+#ifdef HOST_BASELINE_TOUCH_DRIFT
+#undef BASELINE_TOUCH_DRIFT
+#define BASELINE_TOUCH_DRIFT HOST_BASELINE_TOUCH_DRIFT
+#endif
+#ifdef HOST_CELL_GAIN
+#undef CELL_GAIN
+#define CELL_GAIN           HOST_CELL_GAIN
+#endif
+#ifdef HOST_CROSSTALK
+#undef CROSSTALK
+#define CROSSTALK           HOST_CROSSTALK
+#endif
+
+#endif /*__HOST_CONFIG_H__*/
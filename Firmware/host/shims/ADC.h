@@ -0,0 +1,46 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Linux host build : the synchronized reads return the values given by host_adc_read()
+// scan_matrix() reads the cells in its scan order, the host test sets host_adc_read() to feed them
+
+#ifndef __ADC_SHIM_H__
+#define __ADC_SHIM_H__
+
+#include <Arduino.h>
+
+enum class ADC_CONVERSION_SPEED {VERY_HIGH_SPEED, HIGH_SPEED};
+enum class ADC_SAMPLING_SPEED {VERY_HIGH_SPEED, HIGH_SPEED};
+
+extern void (*host_adc_read)(uint8_t* valA_ptr, uint8_t* valB_ptr);
+
+struct ADC_Module {
+  void setAveraging(uint8_t /*num*/) {};
+  void setResolution(uint8_t /*bits*/) {};
+  void setConversionSpeed(ADC_CONVERSION_SPEED /*speed*/) {};
+  void setSamplingSpeed(ADC_SAMPLING_SPEED /*speed*/) {};
+};
+
+class ADC {
+  public:
+    struct Sync_result {
+      int32_t result_adc0;
+      int32_t result_adc1;
+    };
+    ADC_Module* adc0 = &module0;
+    ADC_Module* adc1 = &module1;
+    Sync_result analogSynchronizedRead(uint8_t /*pin0*/, uint8_t /*pin1*/) {
+      uint8_t valA = 0;
+      uint8_t valB = 0;
+      if (host_adc_read != NULL) host_adc_read(&valA, &valB);
+      return {valA, valB};
+    };
+  private:
+    ADC_Module module0;
+    ADC_Module module1;
+};
+
+#endif /*__ADC_SHIM_H__*/
@@ -0,0 +1,55 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Minimal Arduino core for the Linux host build (Firmware/host)
+// Only what the firmware uses : the pins do nothing, Serial prints to stdout, micros() is the host monotonic clock
+
+#ifndef __ARDUINO_SHIM_H__
+#define __ARDUINO_SHIM_H__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH                1
+#define LOW                 0
+#define INPUT               0
+#define OUTPUT              1
+#define INPUT_PULLUP        2
+#define A2                  16
+#define A3                  17
+#define A9                  23
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+uint32_t millis(void);
+uint32_t micros(void);
+void delayMicroseconds(uint32_t us);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+void analogWrite(uint8_t pin, int val);
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+struct HostSerial {
+  void begin(uint32_t /*baud*/) {};
+  int printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int size = vprintf(format, args);
+    va_end(args);
+    return size;
+  };
+  operator bool() { return true; };
+};
+extern HostSerial Serial;
+
+#endif /*__ARDUINO_SHIM_H__*/
@@ -0,0 +1,22 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Linux host build : the buttons are never pressed
+
+#ifndef __BOUNCE2_SHIM_H__
+#define __BOUNCE2_SHIM_H__
+
+namespace Bounce2 {
+struct Button {
+  void attach(int /*pin*/, int /*mode*/) {};
+  void interval(uint16_t /*ms*/) {};
+  void update(void) {};
+  bool rose(void) { return false; };
+  unsigned long previousDuration(void) { return 0; };
+};
+}
+
+#endif /*__BOUNCE2_SHIM_H__*/
@@ -0,0 +1,14 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Linux host build : presets.h needs the declaration, the host storage is storageArray (see storage_read())
+
+#ifndef __EEPROM_SHIM_H__
+#define __EEPROM_SHIM_H__
+
+#include <Arduino.h>
+
+#endif /*__EEPROM_SHIM_H__*/
@@ -0,0 +1,21 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Linux host build : the rotary encoder keeps the last written value
+
+#ifndef __ENCODER_SHIM_H__
+#define __ENCODER_SHIM_H__
+
+class Encoder {
+  public:
+    Encoder(uint8_t /*pinA*/, uint8_t /*pinB*/) {};
+    int32_t read(void) { return position; };
+    void write(int32_t val) { position = val; };
+  private:
+    int32_t position = 0;
+};
+
+#endif /*__ENCODER_SHIM_H__*/
@@ -0,0 +1,29 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Linux host build : the SPI transfers go nowhere
+
+#ifndef __SPI_SHIM_H__
+#define __SPI_SHIM_H__
+
+#include <Arduino.h>
+
+#define MSBFIRST            1
+#define SPI_MODE0           0
+
+struct SPISettings {
+  SPISettings(uint32_t /*clock*/, uint8_t /*bitOrder*/, uint8_t /*dataMode*/) {};
+};
+
+struct SPIClass {
+  void begin(void) {};
+  void beginTransaction(SPISettings /*settings*/) {};
+  uint8_t transfer(uint8_t /*data*/) { return 0; };
+};
+extern SPIClass SPI;
+extern SPIClass SPI1;
+
+#endif /*__SPI_SHIM_H__*/
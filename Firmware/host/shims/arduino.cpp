@@ -0,0 +1,46 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Linux host build : Arduino core functions & shims globals
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <ADC.h>
+#include <time.h>
+
+HostSerial Serial;
+SPIClass SPI;
+SPIClass SPI1;
+void (*host_adc_read)(uint8_t* valA_ptr, uint8_t* valB_ptr) = NULL;
+
+static uint64_t host_clock_us(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static const uint64_t startTime = host_clock_us();
+
+uint32_t micros(void) {
+  return (uint32_t)(host_clock_us() - startTime);
+}
+
+uint32_t millis(void) {
+  return (uint32_t)((host_clock_us() - startTime) / 1000);
+}
+
+void delayMicroseconds(uint32_t us) {
+  uint32_t start = micros();
+  while (micros() - start < us);
+}
+
+void pinMode(uint8_t /*pin*/, uint8_t /*mode*/) {}
+void digitalWrite(uint8_t /*pin*/, uint8_t /*val*/) {}
+void analogWrite(uint8_t /*pin*/, int /*val*/) {}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
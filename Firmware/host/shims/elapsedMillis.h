@@ -0,0 +1,23 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Linux host build : elapsed time counters on the host clock
+
+#ifndef __ELAPSEDMILLIS_SHIM_H__
+#define __ELAPSEDMILLIS_SHIM_H__
+
+#include <Arduino.h>
+
+class elapsedMillis {
+  public:
+    elapsedMillis(void) { start = millis(); };
+    operator unsigned long() const { return millis() - start; };
+    elapsedMillis& operator=(unsigned long val) { start = millis() - val; return *this; };
+  private:
+    unsigned long start;
+};
+
+#endif /*__ELAPSEDMILLIS_SHIM_H__*/
@@ -0,0 +1,25 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Host tests checks : a failed CHECK prints its line and the test returns TEST_RESULT() != 0
+
+#ifndef __HOST_TEST_H__
+#define __HOST_TEST_H__
+
+#include <stdio.h>
+
+static int testFailures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("\n%s:%d: CHECK failed: %s", __FILE__, __LINE__, #cond); \
+      testFailures++; \
+    } \
+  } while (0)
+
+#define TEST_RESULT() (printf("\n%s\n", testFailures == 0 ? "PASS" : "FAIL"), testFailures != 0)
+
+#endif /*__HOST_TEST_H__*/
@@ -0,0 +1,13 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// main.ino globals used by the firmware modules, for the host tests that do not include main.ino
+
+#include "config.h"
+#include "presets.h"
+
+uint8_t currentMode = CALIBRATE;
+uint8_t lastMode = LINE_OUT;
@@ -0,0 +1,118 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Replay of 1 to MAX_BLOBS touches on a grid, slowly moving around their grid position (20 s at 200 fps)
+// Reports the worst case blobs to tracks assignment time (assignmentTime) for each touches count,
+// the smallest of TEST_REPEATS replays (host scheduling spikes are not the assignment time) :
+//  - up to BLOB_ASSIGNMENT_MAX : the optimal assignment (O(n^3))
+//  - above it : the greedy nearest match (O(n^2))
+// The touches must keep their UIDs with both
+
+#include "config.h"
+#include "interp.h"
+#include "blob.h"
+#include "host_test.h"
+
+#define TEST_FRAMES     4000  // 20 s at 200 fps
+#define GRID_COLS       8
+#define GRID_ROWS       4
+#define TOUCHES         (GRID_COLS * GRID_ROWS)
+#define COUNT_FRAMES    (TEST_FRAMES / TOUCHES) // Frames per touches count
+#define NO_UID          0xFF
+#define TEST_REPEATS    3
+#define TEST_BUDGET     50    // Host assignment time budget (us) up to MAX_BLOBS touches
+
+uint8_t testRaw[RAW_FRAME];
+
+static void draw_touch(float cx, float cy, float amplitude, float sigma) {
+  for (int y = 0; y < RAW_ROWS; y++) {
+    for (int x = 0; x < RAW_COLS; x++) {
+      float dist = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      int val = testRaw[y * RAW_COLS + x] + (int)(amplitude * expf(-dist / (2 * sigma * sigma)));
+      testRaw[y * RAW_COLS + x] = constrain(val, 0, 255);
+    }
+  }
+}
+
+// UID of the pressed track closest to the touch (one raw cell), NO_UID if not found
+static uint8_t touch_uid(tracks_t* tracks_ptr, float posX, float posY) {
+  float minDist = SCALE_X;
+  uint8_t uid = NO_UID;
+  for (uint64_t mask = tracks_ptr->liveMask; mask; mask &= mask - 1) {
+    uint8_t id = __builtin_ctzll(mask);
+    if (tracks_ptr->flags[id] & (TRACK_NOT_FOUND | TRACK_MERGED)) continue;
+    float dist = hypotf(tracks_ptr->X[id] - posX, tracks_ptr->Y[id] - posY);
+    if (dist < minDist) {
+      minDist = dist;
+      uid = id;
+    }
+  }
+  return uid;
+}
+
+// One replay, the worst case assignment time of each touches count in maxTime, return the touches lost or given another UID
+static int replay(image_t* rawFrame_ptr, image_t* interpFrame_ptr, tracks_t* tracks_ptr, float* phase_ptr, uint32_t* maxTime_ptr, int* fallbackFrames_ptr) {
+  uint8_t lastUID[TOUCHES];
+  memset(lastUID, NO_UID, sizeof(lastUID));
+  BLOB_SETUP(tracks_ptr);
+  int switches = 0;
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    int count = MIN(1 + frame / COUNT_FRAMES, TOUCHES);  // One more touch every COUNT_FRAMES
+    float posX[TOUCHES];
+    float posY[TOUCHES];
+    memset(testRaw, 0, sizeof(testRaw));
+    for (int k = 0; k < count; k++) {
+      float t = frame * 0.05f + phase_ptr[k];
+      posX[k] = 1 + 2 * (k % GRID_COLS) + 0.1f * sinf(t);
+      posY[k] = 1.5f + 4 * (k / GRID_COLS) + 0.1f * cosf(t);
+      draw_touch(posX[k], posY[k], 110, 0.35f);
+    }
+    frameTime += 5000;
+    interp_matrix(rawFrame_ptr);
+    find_blobs(10, interpFrame_ptr, &interpActiveTiles[0], tracks_ptr);
+    if (frame % COUNT_FRAMES < 10) continue; // New touch birth
+    maxTime_ptr[count] = MAX(maxTime_ptr[count], assignmentTime);
+    if (count > BLOB_ASSIGNMENT_MAX) (*fallbackFrames_ptr)++;
+    for (int k = 0; k < count; k++) {
+      uint8_t uid = touch_uid(tracks_ptr, posX[k] * SCALE_X, posY[k] * SCALE_Y);
+      if (uid == NO_UID || (lastUID[k] != NO_UID && uid != lastUID[k])) switches++;
+      lastUID[k] = uid;
+    }
+  }
+  return switches;
+}
+
+int main(void) {
+  image_t rawFrame = {testRaw, RAW_COLS, RAW_ROWS};
+  image_t interpFrame;
+  tracks_t tracks;
+  INTERP_SETUP(&interpFrame);
+
+  srand(3);
+  float phase[TOUCHES];
+  for (int k = 0; k < TOUCHES; k++) phase[k] = (rand() % 628) / 100.0f;
+
+  uint32_t worstTime[TOUCHES + 1];
+  memset(worstTime, 0xFF, sizeof(worstTime));
+  int switches = 0;
+  int fallbackFrames = 0;
+  for (int repeat = 0; repeat < TEST_REPEATS; repeat++) {
+    uint32_t maxTime[TOUCHES + 1] = {0};
+    switches += replay(&rawFrame, &interpFrame, &tracks, &phase[0], &maxTime[0], &fallbackFrames);
+    for (int count = 1; count <= TOUCHES; count++) worstTime[count] = MIN(worstTime[count], maxTime[count]);
+  }
+  uint32_t worst = 0;
+  printf("Worst case assignment time (us) per touches count (BLOB_ASSIGNMENT_MAX %d) :", BLOB_ASSIGNMENT_MAX);
+  for (int count = 1; count <= TOUCHES; count++) {
+    printf("%s%d:%u", (count - 1) % 8 ? " " : "\n  ", count, worstTime[count]);
+    worst = MAX(worst, worstTime[count]);
+  }
+  printf("\nTouches lost or given another UID : %d, frames above BLOB_ASSIGNMENT_MAX : %d\n", switches, fallbackFrames);
+  CHECK(switches == 0);
+  CHECK(BLOB_ASSIGNMENT_MAX >= TOUCHES || fallbackFrames > 0);
+  CHECK(worst < TEST_BUDGET);
+  return TEST_RESULT();
+}
@@ -0,0 +1,148 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Matrix scan baseline (FRAME_SOURCE_MATRIX, the ADC values are given by host_adc_read()) :
+//  - First boot (no baseline record) : the frames are blank until the calibration is done
+//  - The noise is seeded from the calibration spread, the resting cells give no touch right after the calibration
+//  - A short press keeps its value, a press held for minutes keeps it too (BASELINE_TOUCH_DRIFT 0) or fades out (BASELINE_TOUCH_DRIFT 1)
+//  - The baseline record is saved while nothing touches the matrix & reloaded from the storage
+
+#include "config.h"
+#include "presets.h"
+#include "scan.h"
+#include "host_test.h"
+#include <stddef.h>
+
+#define TEST_REST       30    // Resting cells mean value
+#define TEST_NOISE      4     // Resting cells uniform noise amplitude (+/-)
+#define TEST_PRESS      60    // Pressed cell value above the resting value
+#define TEST_CELL       (5 * RAW_COLS + 9)
+#define TEST_CALIBRATION 10   // Calibration frames (CALIBRATION_CYCLES)
+
+uint8_t testCells[RAW_FRAME];
+uint8_t testFrameArray[RAW_FRAME];
+preset_t presets[7] = {};
+tracks_t tracks = {};
+
+// scan_matrix() order : the columns pairs, then the rows
+static void adc_read(uint8_t* valA_ptr, uint8_t* valB_ptr) {
+  static uint16_t read = 0;
+  uint8_t cols = read / RAW_ROWS;
+  uint8_t row = read % RAW_ROWS;
+  *valA_ptr = testCells[row * RAW_COLS + cols];
+  *valB_ptr = testCells[row * RAW_COLS + cols + RAW_COLS / 2];
+  read = (read + 1) % (RAW_FRAME / 2);
+}
+
+static void rest_cells(int rest = TEST_REST) {
+  for (int i = 0; i < RAW_FRAME; i++) testCells[i] = rest + rand() % (2 * TEST_NOISE + 1) - TEST_NOISE;
+}
+
+// Mean of the cells thresholds saved in the storage baseline record
+static float stored_offset_mean(void) {
+  int sum = 0;
+  for (int i = 0; i < RAW_FRAME; i++) sum += storage_read(STORAGE_BASELINE + offsetof(baseline_t, offset) + i);
+  return sum / (float)RAW_FRAME;
+}
+
+// Scan a frame, return the number of cells above their threshold
+static int scan(image_t* frame_ptr) {
+  calibrate_matrix(&presets[0], &tracks);
+  scan_matrix(frame_ptr);
+  int touched = 0;
+  for (int i = 0; i < RAW_FRAME; i++) touched += (frame_ptr->pData[i] > 0);
+  return touched;
+}
+
+int main(void) {
+  image_t frame = {testFrameArray, RAW_COLS, RAW_ROWS};
+  host_adc_read = adc_read;
+  srand(7);
+
+  CHECK(!baseline_load());
+  int bootTouches = 0;
+  memset(testCells, TEST_REST, RAW_FRAME);
+  for (int i = 0; i < 50; i++) {
+    bootTouches += scan(&frame);
+  }
+  presets[CALIBRATE].update = true;
+  for (int i = 0; i < 20; i++) {
+    rest_cells();
+    if (i < TEST_CALIBRATION) bootTouches += scan(&frame);
+    else scan(&frame);
+  }
+  printf("Cells above their threshold at the first boot, until the calibration is done: %d (60 frames)\n", bootTouches);
+  CHECK(bootTouches == 0);
+  int falseTouches = 0;
+  for (int i = 0; i < 1000; i++) {
+    rest_cells();
+    falseTouches += scan(&frame);
+  }
+  printf("Resting cells above their threshold after the calibration: %d (1000 frames)", falseTouches);
+  CHECK(falseTouches < 20);
+
+  // Short press (1000 frames)
+  int pressStart = 0;
+  int pressEnd = 0;
+  for (int i = 0; i < 1000; i++) {
+    rest_cells();
+    testCells[TEST_CELL] = TEST_REST + TEST_PRESS;
+    scan(&frame);
+    if (i == 0) pressStart = frame.pData[TEST_CELL];
+    pressEnd = frame.pData[TEST_CELL];
+  }
+  printf("\nShort press value: %d to %d", pressStart, pressEnd);
+  CHECK(pressStart > TEST_PRESS - 2 * TEST_NOISE);
+  CHECK(pressEnd > pressStart * 9 / 10);
+  for (int i = 0; i < 1000; i++) {
+    rest_cells();
+    scan(&frame);
+  }
+
+  // Object left on the matrix (1000000 frames, 400 s at 2500 FPS)
+  int frames = 0;
+  int heldEnd = 0;
+  for (; frames < 1000000; frames++) {
+    rest_cells();
+    testCells[TEST_CELL] = TEST_REST + TEST_PRESS;
+    if (scan(&frame) == 0) break;
+    heldEnd = frame.pData[TEST_CELL];
+  }
+#if BASELINE_TOUCH_DRIFT
+  printf("\nHeld press faded out after %d frames", frames);
+  CHECK(frames < 1000000);
+#else
+  printf("\nHeld press value after %d frames: %d", frames, heldEnd);
+  CHECK(frames == 1000000);
+  CHECK(heldEnd > pressStart * 9 / 10);
+#endif
+  for (int i = 0; i < 1000; i++) {
+    rest_cells();
+    scan(&frame);
+  }
+
+  // A new baseline (resting cells 10 higher) is not saved while a track is live, then saved & reloaded
+  CHECK(baseline_load());
+  presets[CALIBRATE].update = true;
+  tracks.liveMask = 1;
+  for (int i = 0; i < 1000; i++) {
+    rest_cells(TEST_REST + 10);
+    scan(&frame);
+  }
+  CHECK(stored_offset_mean() < TEST_REST + TEST_NOISE + 1);
+  tracks.liveMask = 0;
+  int saveFrames = 0;
+  for (; saveFrames < 1000 && stored_offset_mean() < TEST_REST + 10; saveFrames++) {
+    rest_cells(TEST_REST + 10);
+    scan(&frame);
+  }
+  printf("\nBaseline saved in %d idle frames", saveFrames);
+  CHECK(saveFrames < 1000);
+  for (int i = 0; i < 100; i++) scan(&frame);
+  CHECK(baseline_load());
+
+  return TEST_RESULT();
+}
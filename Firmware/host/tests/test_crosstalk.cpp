@@ -0,0 +1,104 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Single touches all over the matrix with a rows & columns ghost pressure (CROSSTALK_ROW_COEF & CROSSTALK_COL_COEF) :
+//  - writes them to TEST_FILE, the crosstalk_fit test must find the coefficients back
+//  - replays them through read_frame() & crosstalk(), the background cells must be cleared
+
+#include "config.h"
+#include "source.h"
+#include "host_test.h"
+
+#define TEST_FILE       "crosstalk.e256"
+#define TEST_FRAMES     2000
+#define TOUCH_RADIUS    2     // Cells around the peak that are not background (crosstalk_fit default)
+#define GHOST_MIN       10    // Background cells above this value are ghost touches
+
+uint8_t testRaw[TEST_FRAMES][RAW_FRAME];
+
+// The ghost pressure is given by the measured values (the firmware model) : measured = touch + ghost(measured)
+static void draw_ghosted_touch(uint8_t* frame_ptr, float cx, float cy, float amplitude, float sigma) {
+  float touch[RAW_FRAME];
+  float measured[RAW_FRAME];
+  for (int y = 0; y < RAW_ROWS; y++) {
+    for (int x = 0; x < RAW_COLS; x++) {
+      float dist = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      touch[y * RAW_COLS + x] = amplitude * expf(-dist / (2 * sigma * sigma));
+      measured[y * RAW_COLS + x] = touch[y * RAW_COLS + x];
+    }
+  }
+  for (int iter = 0; iter < 8; iter++) {
+    float rowSum[RAW_ROWS] = {0};
+    float colSum[RAW_COLS] = {0};
+    for (int i = 0; i < RAW_FRAME; i++) {
+      rowSum[i / RAW_COLS] += measured[i];
+      colSum[i % RAW_COLS] += measured[i];
+    }
+    for (int i = 0; i < RAW_FRAME; i++) {
+      float ghost = (CROSSTALK_ROW_COEF * (rowSum[i / RAW_COLS] - measured[i]) + CROSSTALK_COL_COEF * (colSum[i % RAW_COLS] - measured[i])) / 65536.0f;
+      measured[i] = touch[i] + ghost;
+    }
+  }
+  for (int i = 0; i < RAW_FRAME; i++) {
+    frame_ptr[i] = constrain((int)lroundf(measured[i]), 0, 255);
+  }
+}
+
+static boolean is_background(uint8_t* frame_ptr, int index) {
+  int peak = 0;
+  for (int i = 1; i < RAW_FRAME; i++) {
+    if (frame_ptr[i] > frame_ptr[peak]) peak = i;
+  }
+  return abs(index % RAW_COLS - peak % RAW_COLS) > TOUCH_RADIUS || abs(index / RAW_COLS - peak / RAW_COLS) > TOUCH_RADIUS;
+}
+
+int main(void) {
+  srand(25);
+  FILE* file = fopen(TEST_FILE, "wb");
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    float cx = (rand() % 1600) / 100.0f;
+    float cy = (rand() % 1600) / 100.0f;
+    draw_ghosted_touch(testRaw[frame], cx, cy, 150 + rand() % 100, 0.6f + (rand() % 30) / 100.0f);
+    uint32_t time = frame * 5000;
+    uint8_t header[4] = {(uint8_t)time, (uint8_t)(time >> 8), (uint8_t)(time >> 16), (uint8_t)(time >> 24)};
+    fwrite(header, sizeof(header), 1, file);
+    fwrite(testRaw[frame], RAW_FRAME, 1, file);
+  }
+  fclose(file);
+
+  image_t rawFrame;
+  replayPath = TEST_FILE;
+  SOURCE_SETUP(&rawFrame);
+  double sumSq = 0;
+  double residualSq = 0;
+  long samples = 0;
+  int ghosts = 0;
+  int residualGhosts = 0;
+  int lostPeaks = 0;
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    CHECK(read_frame(&rawFrame));
+    for (int i = 0; i < RAW_FRAME; i++) {
+      uint8_t val = testRaw[frame][i];
+      uint8_t out = rawFrame.pData[i];
+      if (!is_background(testRaw[frame], i)) {
+        if (val >= 150 && out < val * 3 / 4) lostPeaks++;
+        continue;
+      }
+      sumSq += val * val;
+      residualSq += out * out;
+      ghosts += (val >= GHOST_MIN);
+      residualGhosts += (out >= GHOST_MIN);
+      samples++;
+    }
+  }
+  CHECK(!read_frame(&rawFrame));
+  printf("Background RMS %.3f -> %.3f, ghost cells %d -> %d\n", sqrt(sumSq / samples), sqrt(residualSq / samples), ghosts, residualGhosts);
+  CHECK(ghosts > 0);
+  CHECK(residualGhosts == 0);
+  CHECK(residualSq < sumSq / 4);
+  CHECK(lostPeaks == 0);
+  return TEST_RESULT();
+}
@@ -0,0 +1,91 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Matrix scan per cell gain (CELL_GAIN, the ADC values are given by host_adc_read()) :
+//  - the cells sensitivity is spread by +/-45%, each cell is pressed in turn with the same reference press
+//  - the pressed values coefficient of variation before & after the gain calibration (/g 1 then /g 0)
+//  - the gains are saved with the baseline record & reloaded from the storage
+
+#include "config.h"
+#include "presets.h"
+#include "scan.h"
+#include "host_test.h"
+
+#define TEST_REST       20    // Resting cells mean value
+#define TEST_PRESS      100   // Reference press value on a cell of unity sensitivity
+#define PRESS_FRAMES    3     // Frames per pressed cell
+
+uint8_t testFrameArray[RAW_FRAME];
+float cellSensitivity[RAW_FRAME];
+int pressedCell = -1;
+preset_t presets[7] = {};
+tracks_t tracks = {};
+
+extern uint8_t gainArray[RAW_FRAME];
+
+static uint8_t cell_read(int index) {
+  int val = TEST_REST + rand() % 3;
+  if (index == pressedCell) val += (int)(TEST_PRESS * cellSensitivity[index]);
+  return constrain(val, 0, 255);
+}
+
+// scan_matrix() order : the columns pairs, then the rows
+static void adc_read(uint8_t* valA_ptr, uint8_t* valB_ptr) {
+  static uint16_t read = 0;
+  uint8_t cols = read / RAW_ROWS;
+  uint8_t row = read % RAW_ROWS;
+  *valA_ptr = cell_read(row * RAW_COLS + cols);
+  *valB_ptr = cell_read(row * RAW_COLS + cols + RAW_COLS / 2);
+  read = (read + 1) % (RAW_FRAME / 2);
+}
+
+static void scan(image_t* frame_ptr) {
+  calibrate_matrix(&presets[0], &tracks);
+  scan_matrix(frame_ptr);
+}
+
+// Press each cell in turn, return the pressed values coefficient of variation
+static float press_sequence(image_t* frame_ptr) {
+  float sum = 0;
+  float sumSq = 0;
+  for (pressedCell = 0; pressedCell < RAW_FRAME; pressedCell++) {
+    for (int i = 0; i < PRESS_FRAMES; i++) scan(frame_ptr);
+    float val = frame_ptr->pData[pressedCell];
+    sum += val;
+    sumSq += val * val;
+  }
+  pressedCell = -1;
+  float mean = sum / RAW_FRAME;
+  return sqrtf(sumSq / RAW_FRAME - mean * mean) / mean;
+}
+
+int main(void) {
+  image_t frame = {testFrameArray, RAW_COLS, RAW_ROWS};
+  host_adc_read = adc_read;
+  srand(7);
+  for (int i = 0; i < RAW_FRAME; i++) cellSensitivity[i] = 0.6f + 0.9f * ((i * 37) % 100) / 100.0f;
+
+  GAIN_SETUP();
+  presets[CALIBRATE].update = true;
+  for (int i = 0; i < 200; i++) scan(&frame);
+
+  float cvBefore = press_sequence(&frame);
+  gain_calibrate_start();
+  press_sequence(&frame);
+  gain_calibrate_end();
+  float cvAfter = press_sequence(&frame);
+  printf("Pressed cells coefficient of variation: %.3f before, %.3f after the gain calibration", cvBefore, cvAfter);
+  CHECK(cvBefore > 0.2f);
+  CHECK(cvAfter < 0.05f);
+
+  uint8_t gains[RAW_FRAME];
+  memcpy(gains, gainArray, RAW_FRAME);
+  for (int i = 0; i < 200; i++) scan(&frame); // Idle frames, the baseline record is written
+  memset(gainArray, 0, RAW_FRAME);
+  CHECK(baseline_load());
+  CHECK(memcmp(gains, gainArray, RAW_FRAME) == 0);
+  return TEST_RESULT();
+}
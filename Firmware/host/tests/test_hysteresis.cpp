@@ -0,0 +1,122 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Blob hysteresis & birth/death confirmation :
+//  - A new blob must be above the seed threshold, its depth is given above the seed threshold (clamped at 0)
+//  - A light touch hovering around the threshold with noise spikes : count the presses, the spikes never press
+
+#include "config.h"
+#include "interp.h"
+#include "blob.h"
+#include "host_test.h"
+
+#define TEST_THRESHOLD  16
+#define TEST_FRAMES     4000
+
+uint8_t testRaw[RAW_FRAME];
+uint8_t testBlobArray[NEW_FRAME];
+
+static void draw_touch(float cx, float cy, float amplitude, float sigma) {
+  for (int y = 0; y < RAW_ROWS; y++) {
+    for (int x = 0; x < RAW_COLS; x++) {
+      float dist = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      int val = testRaw[y * RAW_COLS + x] + (int)(amplitude * expf(-dist / (2 * sigma * sigma)));
+      testRaw[y * RAW_COLS + x] = constrain(val, 0, 255);
+    }
+  }
+}
+
+// Flat square touch on the interpolated frame
+static void draw_plateau(uint8_t val) {
+  memset(testBlobArray, 0, sizeof(testBlobArray));
+  for (int y = 20; y < 26; y++) {
+    for (int x = 20; x < 26; x++) testBlobArray[y * NEW_COLS + x] = val;
+  }
+}
+
+static int count_tracks(tracks_t* tracks_ptr) {
+  return __builtin_popcountll(tracks_ptr->liveMask | tracks_ptr->pendingMask);
+}
+
+int main(void) {
+  image_t blobFrame = {testBlobArray, NEW_COLS, NEW_ROWS};
+  uint16_t activeTiles[RAW_ROWS];
+  tracks_t tracks;
+  memset(activeTiles, 0xFF, sizeof(activeTiles));
+
+  // A blob at the seed threshold does not start a track
+  BLOB_SETUP(&tracks);
+  draw_plateau(TEST_THRESHOLD);
+  for (int i = 0; i < BLOB_BIRTH_FRAMES + 1; i++) {
+    frameTime += 5000;
+    find_blobs(TEST_THRESHOLD, &blobFrame, &activeTiles[0], &tracks);
+  }
+  CHECK(count_tracks(&tracks) == 0);
+
+  // A blob above the seed threshold starts a track, its depth is given above the seed threshold
+  draw_plateau(TEST_THRESHOLD + 5);
+  for (int i = 0; i < BLOB_BIRTH_FRAMES + 1; i++) {
+    frameTime += 5000;
+    find_blobs(TEST_THRESHOLD, &blobFrame, &activeTiles[0], &tracks);
+  }
+  CHECK(tracks.liveMask != 0);
+  uint8_t id = __builtin_ctzll(tracks.liveMask);
+  printf("Depth above the seed threshold: %d", tracks.D[id]);
+  CHECK(tracks.D[id] == 5);
+
+#if BLOB_HYSTERESIS > 0
+  // The found blob is kept down to the low threshold, with a null depth
+  draw_plateau(TEST_THRESHOLD - BLOB_HYSTERESIS + 1);
+  for (int i = 0; i < 20; i++) {
+    frameTime += 5000;
+    find_blobs(TEST_THRESHOLD, &blobFrame, &activeTiles[0], &tracks);
+  }
+  CHECK((tracks.liveMask >> id) & 1);
+  CHECK(tracks.D[id] == 0);
+#endif
+
+  // Light touch (cell 5, 5) hovering around the threshold, firm touch (cell 11, 11), single frame noise spikes
+  image_t rawFrame = {testRaw, RAW_COLS, RAW_ROWS};
+  image_t interpFrame;
+  INTERP_SETUP(&interpFrame);
+  BLOB_SETUP(&tracks);
+  srand(5);
+  int presses = 0;
+  int spikePresses = 0;
+  int spikes = 0;
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    memset(testRaw, 0, sizeof(testRaw));
+    draw_touch(5, 5, 16 + (rand() % 7 - 3), 1.0);
+    draw_touch(11, 11, 60, 1.0);
+    if (rand() % 20 == 0) {
+      testRaw[rand() % RAW_FRAME] = 10 + rand() % 20;
+      spikes++;
+    }
+    for (int i = 0; i < RAW_FRAME; i++) {
+      int val = testRaw[i] + rand() % 5 - 2;
+      testRaw[i] = constrain(val, 0, 255);
+    }
+    frameTime += 5000;
+    interp_matrix(&rawFrame);
+    find_blobs(TEST_THRESHOLD, &interpFrame, &interpActiveTiles[0], &tracks);
+    for (uint64_t mask = tracks.liveMask; mask; mask &= mask - 1) {
+      uint8_t id = __builtin_ctzll(mask);
+      if (TRACK_GET_STATE(&tracks, id) && !TRACK_GET_LAST_STATE(&tracks, id)) {
+        presses++;
+        float touchX = (tracks.X[id] < 8 * SCALE_X) ? 5 * SCALE_X : 11 * SCALE_X;
+        float touchY = (tracks.Y[id] < 8 * SCALE_Y) ? 5 * SCALE_Y : 11 * SCALE_Y;
+        if (fabsf(tracks.X[id] - touchX) > 2 * SCALE_X || fabsf(tracks.Y[id] - touchY) > 2 * SCALE_Y) spikePresses++;
+      }
+    }
+  }
+  printf("\nLight touch & %d noise spikes over %d frames: %d presses, %d spikes presses", spikes, TEST_FRAMES, presses, spikePresses);
+#if BLOB_BIRTH_FRAMES > 1
+  CHECK(spikePresses == 0);
+  CHECK(presses < 300);
+#endif
+
+  return TEST_RESULT();
+}
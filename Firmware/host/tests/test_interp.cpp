@@ -0,0 +1,192 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// The selected interpolation kernel (INTERP_KERNEL) against a float reference, for each scale factor & random frames :
+//  - the bilinear kernels against the float bilinear kernel, bit exact at the power of two scales
+//  - the bicubic kernel against the float Catmull-Rom kernel (Q8 weights & Q4 horizontal pass rounding)
+// Only the active tiles are interpolated, the other ones must stay at 0
+// INTERP_DIRTY_TILES : a resting touch with small local changes only re-interpolates a few tiles & matches the full interpolation
+
+#include "config.h"
+#include "interp.h"
+#include "host_test.h"
+
+#define TEST_FRAMES     200
+#define TEST_TILES      ((RAW_COLS - 1) * (RAW_ROWS - 1))
+#define TEST_CHANGES    2     // Changed cells per frame under the resting touch
+
+#if INTERP_KERNEL == BICUBIC_CATMULL_ROM
+#define MAX_ERROR       1
+#else
+#define MAX_ERROR       0
+#endif
+
+uint8_t testRaw[RAW_FRAME];
+uint8_t refArray[MAX_NEW_FRAME];
+
+static float raw_value(int col, int row) {
+  col = constrain(col, 0, RAW_COLS - 1);
+  row = constrain(row, 0, RAW_ROWS - 1);
+  return testRaw[row * RAW_COLS + col];
+}
+
+#if INTERP_KERNEL == BICUBIC_CATMULL_ROM
+static void catmull_rom(float t, float* w) {
+  w[0] = (-t * t * t + 2 * t * t - t) / 2;
+  w[1] = (3 * t * t * t - 5 * t * t + 2) / 2;
+  w[2] = (-3 * t * t * t + 4 * t * t + t) / 2;
+  w[3] = (t * t * t - t * t) / 2;
+}
+#endif
+
+// Output pixel (col, row) of the tile (colPos, rowPos)
+static uint8_t reference_pixel(int colPos, int rowPos, int col, int row, int scale) {
+  float tx = col / (float)scale;
+  float ty = row / (float)scale;
+#if INTERP_KERNEL == BICUBIC_CATMULL_ROM
+  float wx[4];
+  float wy[4];
+  catmull_rom(tx, wx);
+  catmull_rom(ty, wy);
+  float sum = 0;
+  for (int j = 0; j < 4; j++) {
+    for (int i = 0; i < 4; i++) {
+      sum += wy[j] * wx[i] * raw_value(colPos - 1 + i, rowPos - 1 + j);
+    }
+  }
+  return (uint8_t)constrain(lroundf(sum), 0, 255);
+#else
+  float sum =
+    raw_value(colPos, rowPos) * (1 - tx) * (1 - ty) +
+    raw_value(colPos + 1, rowPos) * tx * (1 - ty) +
+    raw_value(colPos, rowPos + 1) * (1 - tx) * ty +
+    raw_value(colPos + 1, rowPos + 1) * tx * ty;
+  return (uint8_t)lroundf(sum);
+#endif
+}
+
+static void reference_frame(int scale) {
+  int outputCols = RAW_COLS * scale;
+  memset(refArray, 0, sizeof(refArray));
+  for (int rowPos = 0; rowPos < RAW_ROWS - 1; rowPos++) {
+    for (int colPos = 0; colPos < RAW_COLS - 1; colPos++) {
+      if (!((interpActiveTiles[rowPos] >> colPos) & 1)) continue;
+      for (int row = 0; row < scale; row++) {
+        for (int col = 0; col < scale; col++) {
+          refArray[(rowPos * scale + row) * outputCols + colPos * scale + col] = reference_pixel(colPos, rowPos, col, row, scale);
+        }
+      }
+    }
+  }
+}
+
+// Random pressure with empty areas, so that some tiles are not active
+static void random_frame(void) {
+  for (int i = 0; i < RAW_FRAME; i++) {
+    testRaw[i] = (rand() % 3) ? 0 : rand() % 256;
+  }
+}
+
+#if INTERP_DIRTY_TILES
+// Resting gaussian touch centered on posX, posY
+static void resting_touch(float posX, float posY) {
+  for (int row = 0; row < RAW_ROWS; row++) {
+    for (int col = 0; col < RAW_COLS; col++) {
+      float dist = (col - posX) * (col - posX) + (row - posY) * (row - posY);
+      testRaw[row * RAW_COLS + col] = (uint8_t)(120 * expf(-dist / 2.88f));
+    }
+  }
+}
+
+// Run the resting touch frames with TEST_CHANGES cells changed by up to +/-8 under the touch, return the max error against the reference
+static int dirty_frames(image_t* rawFrame_ptr, image_t* interpFrame_ptr, int* maxDirty_ptr, long* dirtyTiles_ptr) {
+  int maxError = 0;
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    for (int i = 0; i < TEST_CHANGES; i++) {
+      int index = (5 + rand() % 5) * RAW_COLS + 5 + rand() % 5;
+      testRaw[index] = constrain(testRaw[index] + rand() % 17 - 8, 0, 255);
+    }
+    interp_matrix(rawFrame_ptr);
+    reference_frame(SCALE_X);
+    *maxDirty_ptr = MAX(*maxDirty_ptr, (int)interpDirtyTiles);
+    *dirtyTiles_ptr += interpDirtyTiles;
+    for (int index = 0; index < interpFrame_ptr->numCols * interpFrame_ptr->numRows; index++) {
+      maxError = MAX(maxError, abs(interpFrame_ptr->pData[index] - refArray[index]));
+    }
+  }
+  return maxError;
+}
+#endif
+
+int main(void) {
+  image_t rawFrame = {testRaw, RAW_COLS, RAW_ROWS};
+  image_t interpFrame;
+  INTERP_SETUP(&interpFrame);
+#if INTERP_DIRTY_TILES
+  interpNoiseTolerance = 0; // The dirty tiles reference is the input frame
+#endif
+
+  srand(1);
+  const uint8_t scales[] = {1, 2, 4, 8};
+  for (uint8_t i = 0; i < sizeof(scales); i++) {
+    if (scales[i] > MAX_SCALE) continue;
+    CHECK(interp_set_scale(scales[i], &interpFrame));
+    int maxError = 0;
+    long activeTiles = 0;
+    for (int frame = 0; frame < TEST_FRAMES; frame++) {
+      random_frame();
+      interp_matrix(&rawFrame);
+      reference_frame(scales[i]);
+      for (int row = 0; row < RAW_ROWS; row++) {
+        activeTiles += __builtin_popcount(interpActiveTiles[row]);
+      }
+      for (int index = 0; index < interpFrame.numCols * interpFrame.numRows; index++) {
+        maxError = MAX(maxError, abs(interpFrame.pData[index] - refArray[index]));
+      }
+    }
+    printf("Kernel %d / scale %d : max error %d (%ld active tiles)\n", INTERP_KERNEL, scales[i], maxError, activeTiles);
+    CHECK(activeTiles > 0 && activeTiles < (long)TEST_FRAMES * (RAW_COLS - 1) * (RAW_ROWS - 1));
+    CHECK(maxError <= MAX_ERROR);
+  }
+
+#if INTERP_DIRTY_TILES
+  // The first frame refreshes every tile, the next ones only the tiles around the changed cells
+  CHECK(interp_set_scale(SCALE_X, &interpFrame));
+  resting_touch(7.3f, 7.6f);
+  interp_matrix(&rawFrame);
+  CHECK(interpDirtyTiles == TEST_TILES);
+  int maxDirty = 0;
+  long dirtyTiles = 0;
+  int maxError = dirty_frames(&rawFrame, &interpFrame, &maxDirty, &dirtyTiles);
+  printf("Dirty tiles / resting touch : max %d mean %.1f of %d tiles, max error %d\n", maxDirty, dirtyTiles / (float)TEST_FRAMES, TEST_TILES, maxError);
+  CHECK(maxDirty > 0 && maxDirty <= TEST_CHANGES * 4);
+  CHECK(maxError <= MAX_ERROR);
+
+  // Changes below the noise tolerance are ignored : the tiles are not refreshed & stay within the tolerance of the full interpolation
+  interpNoiseTolerance = 1;
+  interp_matrix(&rawFrame);
+  int noiseTiles = 0;
+  int noiseError = 0;
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    uint8_t restArray[RAW_FRAME];
+    memcpy(restArray, testRaw, RAW_FRAME);
+    for (int i = 0; i < RAW_FRAME; i++) {
+      if (testRaw[i] > 0 && testRaw[i] < 255) testRaw[i] += rand() % 3 - 1;
+    }
+    interp_matrix(&rawFrame);
+    reference_frame(SCALE_X);
+    noiseTiles += interpDirtyTiles;
+    for (int index = 0; index < interpFrame.numCols * interpFrame.numRows; index++) {
+      noiseError = MAX(noiseError, abs(interpFrame.pData[index] - refArray[index]));
+    }
+    memcpy(testRaw, restArray, RAW_FRAME);
+  }
+  printf("Dirty tiles / resting touch with +/-1 noise : %d, max error %d\n", noiseTiles, noiseError);
+  CHECK(noiseTiles == 0);
+  CHECK(noiseError <= MAX_ERROR + 1);
+#endif
+  return TEST_RESULT();
+}
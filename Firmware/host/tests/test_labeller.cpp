@@ -0,0 +1,163 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Blob labellers (built once per BLOB_LABELLER) :
+//  - The blobs of random multi-touch frames match a brute force 4-connected labelling (centroid, box, ellipse)
+//  - A touch next to a tracked touch, in a tile crossed by the tracked touch blob, is found (flood fill sweep)
+
+#include <algorithm>
+#include "config.h"
+#include "interp.h"
+#include "blob.h"
+#include "host_test.h"
+
+#define TEST_THRESHOLD  10
+#define TEST_FRAMES     200
+
+uint8_t testRaw[RAW_FRAME];
+uint8_t testBlobArray[NEW_FRAME];
+int refLabels[NEW_FRAME];
+int refStack[NEW_FRAME];
+
+static void draw_touch(uint8_t* frame_ptr, float cx, float cy, float amplitude, float sx, float sy, float theta) {
+  for (int y = 0; y < RAW_ROWS; y++) {
+    for (int x = 0; x < RAW_COLS; x++) {
+      float dx = x - cx;
+      float dy = y - cy;
+      float u = dx * cosf(theta) + dy * sinf(theta);
+      float v = -dx * sinf(theta) + dy * cosf(theta);
+      int val = frame_ptr[y * RAW_COLS + x] + (int)(amplitude * expf(-(u * u / (2 * sx * sx) + v * v / (2 * sy * sy))));
+      frame_ptr[y * RAW_COLS + x] = std::min(val, 255);
+    }
+  }
+}
+
+static int count_tracks(tracks_t* tracks_ptr) {
+  return __builtin_popcountll(tracks_ptr->liveMask | tracks_ptr->pendingMask);
+}
+
+int main(void) {
+  image_t rawFrame = {testRaw, RAW_COLS, RAW_ROWS};
+  image_t interpFrame;
+  tracks_t tracks;
+  INTERP_SETUP(&interpFrame);
+  srand(3);
+
+  int refBlobs = 0;
+  int matchedBlobs = 0;
+  double maxError[6] = {0};
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    memset(testRaw, 0, sizeof(testRaw));
+    int touches = 1 + rand() % 5;
+    for (int i = 0; i < touches; i++) {
+      float cx = rand() % 1600 / 100.0f;
+      float cy = rand() % 1600 / 100.0f;
+      float amplitude = 40 + rand() % 150;
+      float sx = 0.6f + rand() % 100 / 100.0f;
+      float sy = 0.6f + rand() % 100 / 100.0f;
+      float theta = rand() % 314 / 100.0f;
+      draw_touch(testRaw, cx, cy, amplitude, sx, sy, theta);
+    }
+    BLOB_SETUP(&tracks);
+    interp_matrix(&rawFrame);
+    find_blobs(TEST_THRESHOLD, &interpFrame, &interpActiveTiles[0], &tracks);
+
+    // Brute force 4-connected labelling of the pixels above the threshold
+    int cols = interpFrame.numCols;
+    int rows = interpFrame.numRows;
+    uint8_t* pixels = interpFrame.pData;
+    memset(refLabels, 0, sizeof(refLabels));
+    int label = 0;
+    for (int y = 0; y < rows; y++) {
+      for (int x = 0; x < cols; x++) {
+        if (refLabels[y * cols + x] || pixels[y * cols + x] <= TEST_THRESHOLD) continue;
+        label++;
+        int top = 0;
+        refStack[top++] = y * cols + x;
+        refLabels[y * cols + x] = label;
+        double m = 0, mx = 0, my = 0, mxx = 0, myy = 0, mxy = 0;
+        int count = 0, x1 = cols, x2 = -1, y1 = rows, y2 = -1;
+        while (top) {
+          int index = refStack[--top];
+          int px = index % cols;
+          int py = index / cols;
+          double w = pixels[index] - TEST_THRESHOLD;
+          count++;
+          m += w; mx += w * px; my += w * py;
+          mxx += w * px * px; myy += w * py * py; mxy += w * px * py;
+          x1 = std::min(x1, px); x2 = std::max(x2, px);
+          y1 = std::min(y1, py); y2 = std::max(y2, py);
+          int next[4] = {px > 0 ? index - 1 : -1, px < cols - 1 ? index + 1 : -1, py > 0 ? index - cols : -1, py < rows - 1 ? index + cols : -1};
+          for (int i = 0; i < 4; i++) {
+            if (next[i] >= 0 && !refLabels[next[i]] && pixels[next[i]] > TEST_THRESHOLD) {
+              refLabels[next[i]] = label;
+              refStack[top++] = next[i];
+            }
+          }
+        }
+        if (count <= 5) continue;
+        refBlobs++;
+        double cx = mx / m;
+        double cy = my / m;
+        double vx = mxx / m - cx * cx;
+        double vy = myy / m - cy * cy;
+        double cv = mxy / m - cx * cy;
+        double d = sqrt((vx - vy) * (vx - vy) / 4 + cv * cv);
+        double major = 4 * sqrt((vx + vy) / 2 + d);
+        double minor = 4 * sqrt(std::max(0.0, (vx + vy) / 2 - d));
+        int best = -1;
+        double bestDist = 1e9;
+        for (uint64_t mask = tracks.liveMask | tracks.pendingMask; mask; mask &= mask - 1) {
+          int id = __builtin_ctzll(mask);
+          double dist = hypot(tracks.X[id] - cx, tracks.Y[id] - cy);
+          if (dist < bestDist) {
+            bestDist = dist;
+            best = id;
+          }
+        }
+        if (best < 0 || bestDist > 1) continue;
+        matchedBlobs++;
+        double error[6] = {
+          fabs(tracks.X[best] - cx), fabs(tracks.Y[best] - cy),
+          fabs(tracks.W[best] - (x2 - x1 + 1.0)), fabs(tracks.H[best] - (y2 - y1 + 1.0)),
+          fabs(tracks.major[best] - major), fabs(tracks.minor[best] - minor)
+        };
+        for (int i = 0; i < 6; i++) maxError[i] = std::max(maxError[i], error[i]);
+      }
+    }
+  }
+  printf("Reference blobs: %d matched: %d / max error X: %.4f Y: %.4f W: %.0f H: %.0f major: %.4f minor: %.4f",
+         refBlobs, matchedBlobs, maxError[0], maxError[1], maxError[2], maxError[3], maxError[4], maxError[5]);
+  CHECK(refBlobs > 300);
+  CHECK(matchedBlobs == refBlobs);
+  CHECK(maxError[0] < 0.01 && maxError[1] < 0.01);
+  CHECK(maxError[2] == 0 && maxError[3] == 0);
+  CHECK(maxError[4] < 0.01 && maxError[5] < 0.01);
+
+  // Tracked touch A (pixel row 20, crossing the tiles 2 to 10 of the raw row 5)
+  // New touch B (pixel rows 22 & 23) in the tile 6 of the raw row 5, not connected to A
+  image_t blobFrame = {testBlobArray, NEW_COLS, NEW_ROWS};
+  uint16_t activeTiles[RAW_ROWS] = {0};
+  memset(testBlobArray, 0, sizeof(testBlobArray));
+  for (int x = 8; x <= 40; x++) testBlobArray[20 * NEW_COLS + x] = 100;
+  activeTiles[5] = 0x07FC;
+  BLOB_SETUP(&tracks);
+  for (int i = 0; i < BLOB_BIRTH_FRAMES + 1; i++) {
+    frameTime += 5000;
+    find_blobs(TEST_THRESHOLD, &blobFrame, &activeTiles[0], &tracks);
+  }
+  CHECK(count_tracks(&tracks) == 1);
+  CHECK(tracks.liveMask != 0);
+  for (int y = 22; y <= 23; y++) {
+    for (int x = 24; x <= 27; x++) testBlobArray[y * NEW_COLS + x] = 100;
+  }
+  frameTime += 5000;
+  find_blobs(TEST_THRESHOLD, &blobFrame, &activeTiles[0], &tracks);
+  printf("\nTracked touch + new touch in a covered tile: %d tracks", count_tracks(&tracks));
+  CHECK(count_tracks(&tracks) == 2);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,113 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Two touches sliding together then apart :
+//  - BLOB_LINEAGE : one merge then one split event, the touches get their UIDs back, the events are given in their frame only
+//  - BLOB_SPLIT : the merged blob is split at its pressure peaks, the touches are merged much closer
+//    & two touches held 3.5 cells apart keep their own blob & centroid
+
+#include "config.h"
+#include "interp.h"
+#include "blob.h"
+#include "host_test.h"
+
+#define TEST_FRAMES     41
+
+uint8_t testRaw[RAW_FRAME];
+
+static void draw_touch(float cx, float cy, float amplitude, float sigma) {
+  for (int y = 0; y < RAW_ROWS; y++) {
+    for (int x = 0; x < RAW_COLS; x++) {
+      float dist = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      int val = testRaw[y * RAW_COLS + x] + (int)(amplitude * expf(-dist / (2 * sigma * sigma)));
+      testRaw[y * RAW_COLS + x] = constrain(val, 0, 255);
+    }
+  }
+}
+
+// Pressed & visible tracks
+static int count_pressed(tracks_t* tracks_ptr) {
+  int count = 0;
+  for (uint64_t mask = tracks_ptr->liveMask; mask; mask &= mask - 1) {
+    uint8_t id = __builtin_ctzll(mask);
+    if (TRACK_GET_STATE(tracks_ptr, id) && !(tracks_ptr->flags[id] & TRACK_MERGED)) count++;
+  }
+  return count;
+}
+
+int main(void) {
+  image_t rawFrame = {testRaw, RAW_COLS, RAW_ROWS};
+  image_t interpFrame;
+  tracks_t tracks;
+  INTERP_SETUP(&interpFrame);
+  BLOB_SETUP(&tracks);
+
+  int merges = 0;
+  int splits = 0;
+  int lastEventFrame = -2;
+  float mergeDist = 0;
+  int minPressed = MAX_BLOBS;
+  uint64_t firstMask = 0;
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    float dist = 0.5f + fabsf(frame - 20) * 0.3f;
+    memset(testRaw, 0, sizeof(testRaw));
+    draw_touch(7.5f - dist / 2, 7.5f, 110, 1.0f);
+    draw_touch(7.5f + dist / 2, 7.8f, 90, 1.0f);
+    frameTime += 5000;
+    interp_matrix(&rawFrame);
+    find_blobs(10, &interpFrame, &interpActiveTiles[0], &tracks);
+    if (frame == 5) firstMask = tracks.liveMask;
+    if (frame >= 5) minPressed = MIN(minPressed, count_pressed(&tracks));
+    if (tracks.eventCount > 0) {
+      CHECK(lastEventFrame != frame - 1); // The events of the last frame are not given again
+      lastEventFrame = frame;
+    }
+    for (uint8_t i = 0; i < tracks.eventCount; i++) {
+      if (tracks.events[i].type == TRACK_EVENT_MERGE) {
+        merges++;
+        mergeDist = dist;
+      }
+      if (tracks.events[i].type == TRACK_EVENT_SPLIT) splits++;
+    }
+  }
+  printf("Merge events: %d split events: %d / merged at %.1f cells / UIDs kept: %d", merges, splits, mergeDist, tracks.liveMask == firstMask);
+  CHECK(__builtin_popcountll(firstMask) == 2);
+  CHECK(tracks.liveMask == firstMask);
+  CHECK(merges == 1 && splits == 1);
+  CHECK(minPressed == 1);
+#if BLOB_SPLIT
+  CHECK(mergeDist < 3);
+#else
+  CHECK(mergeDist > 5);
+#endif
+
+  // Two touches held 3.5 cells apart : one blob each, at its own pressure peak (BLOB_SPLIT) or a single merged blob
+  BLOB_SETUP(&tracks);
+  float touchX[2] = {7.5f - 1.75f, 7.5f + 1.75f};
+  for (int frame = 0; frame < 10; frame++) {
+    memset(testRaw, 0, sizeof(testRaw));
+    draw_touch(touchX[0], 7.5f, 110, 1.0f);
+    draw_touch(touchX[1], 7.8f, 90, 1.0f);
+    frameTime += 5000;
+    interp_matrix(&rawFrame);
+    find_blobs(10, &interpFrame, &interpActiveTiles[0], &tracks);
+  }
+  float maxError = 0;
+  for (uint64_t mask = tracks.liveMask; mask; mask &= mask - 1) {
+    uint8_t id = __builtin_ctzll(mask);
+    float error = MIN(fabsf(tracks.X[id] - touchX[0] * SCALE_X), fabsf(tracks.X[id] - touchX[1] * SCALE_X));
+    maxError = MAX(maxError, error);
+  }
+  printf("\nHeld 3.5 cells apart : %d pressed, centroids error %.2f px", count_pressed(&tracks), maxError);
+#if BLOB_SPLIT
+  CHECK(count_pressed(&tracks) == 2);
+  CHECK(maxError < 0.5f * SCALE_X);
+#else
+  CHECK(count_pressed(&tracks) == 1);
+#endif
+
+  return TEST_RESULT();
+}
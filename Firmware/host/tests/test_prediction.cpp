@@ -0,0 +1,65 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// A sinusoidal slide at 200 fps, sent 3 ms after the scan :
+// the tracks filtered positions against the positions predicted to the transmission time (BLOB_PREDICTION)
+
+#include "config.h"
+#include "interp.h"
+#include "blob.h"
+#include "host_test.h"
+
+#define TEST_FRAMES     2000
+#define FRAME_PERIOD    5000  // 200 fps
+#define SEND_LATENCY    3000  // Scan to transmission time (us)
+
+uint8_t testRaw[RAW_FRAME];
+
+static void draw_touch(float cx, float cy, float amplitude, float sigma) {
+  for (int y = 0; y < RAW_ROWS; y++) {
+    for (int x = 0; x < RAW_COLS; x++) {
+      float dist = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      int val = testRaw[y * RAW_COLS + x] + (int)(amplitude * expf(-dist / (2 * sigma * sigma)));
+      testRaw[y * RAW_COLS + x] = constrain(val, 0, 255);
+    }
+  }
+}
+
+static float touch_x(uint32_t time) {
+  return 7.5f + 5 * sinf(time * 2e-6f); // Raw cells
+}
+
+int main(void) {
+  image_t rawFrame = {testRaw, RAW_COLS, RAW_ROWS};
+  image_t interpFrame;
+  tracks_t tracks;
+  INTERP_SETUP(&interpFrame);
+  BLOB_SETUP(&tracks);
+
+  double filteredError = 0;
+  double predictedError = 0;
+  int count = 0;
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    frameTime = frame * FRAME_PERIOD;
+    memset(testRaw, 0, sizeof(testRaw));
+    draw_touch(touch_x(frameTime), 7.5f, 110, 1.0f);
+    interp_matrix(&rawFrame);
+    find_blobs(10, &interpFrame, &interpActiveTiles[0], &tracks);
+    if (frame < 20) continue;
+    CHECK(__builtin_popcountll(tracks.liveMask) == 1);
+    uint8_t id = __builtin_ctzll(tracks.liveMask);
+    float truth = touch_x(frameTime + SEND_LATENCY) * SCALE_X;
+    filteredError += fabsf(tracks.X[id] - truth);
+    blobs_predict(&tracks, frameTime + SEND_LATENCY);
+    predictedError += fabsf(tracks.X[id] - truth);
+    count++;
+  }
+  filteredError /= count;
+  predictedError /= count;
+  printf("Mean error at the transmission time : filtered %.3f px, predicted %.3f px\n", filteredError, predictedError);
+  CHECK(predictedError < filteredError);
+  return TEST_RESULT();
+}
@@ -0,0 +1,58 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Presets storage :
+//  - First boot (no presets record) : the default presets are kept
+//  - The SAVE mode (BUTTON_L long press) writes the presets record, the next boot loads it
+//  - The stored values are constrained to the presets ranges
+
+#include "config.h"
+#include "presets.h"
+#include "host_test.h"
+
+preset_t defaults[7] = {
+  {13, 31, 29, 0, false, false, false, LOW,  LOW },  // LINE_OUT
+  { 1, 50, 12, 0, false, false, false, HIGH, LOW },  // SIG_IN
+  { 1, 31, 17, 0, false, false, false, LOW,  HIGH},  // SIG_OUT
+  { 5, 30, 10, 0, false, false, false, HIGH, HIGH},  // THRESHOLD
+  { 1, 6,  1,  0, false, false, false, NULL, NULL},  // MIDI_LEARN
+  { 0, 0,  0,  0, true,  true,  false, NULL, NULL},  // CALIBRATE
+  { 0, 0,  0,  0, false, false, false, NULL, NULL}   // SAVE
+};
+preset_t presets[7];
+
+int main(void) {
+  memcpy(presets, defaults, sizeof(presets));
+  CHECK(!preset_load(&presets[0], &presets[SAVE].update));
+  for (int i = 0; i < 4; i++) CHECK(presets[i].val == defaults[i].val);
+
+  // SAVE mode
+  presets[LINE_OUT].val = 20;
+  presets[SIG_IN].val = 40;
+  presets[SIG_OUT].val = 3;
+  presets[THRESHOLD].val = 25;
+  currentMode = SAVE;
+  presets[SAVE].update = true;
+  update_presets(&presets[0]);
+  CHECK(!presets[SAVE].update);
+
+  // Next boot
+  memcpy(presets, defaults, sizeof(presets));
+  CHECK(preset_load(&presets[0], &presets[SAVE].update));
+  CHECK(presets[LINE_OUT].val == 20);
+  CHECK(presets[SIG_IN].val == 40);
+  CHECK(presets[SIG_OUT].val == 3);
+  CHECK(presets[THRESHOLD].val == 25);
+  CHECK(interpThreshold == 20);
+  printf("Presets loaded: %d %d %d %d (threshold %d)\n", presets[LINE_OUT].val, presets[SIG_IN].val, presets[SIG_OUT].val, presets[THRESHOLD].val, interpThreshold);
+
+  // Out of range stored value
+  storage_write(STORAGE_PRESETS + THRESHOLD, 200);
+  CHECK(preset_load(&presets[0], &presets[SAVE].update));
+  CHECK(presets[THRESHOLD].val == defaults[THRESHOLD].maxVal);
+
+  return TEST_RESULT();
+}
@@ -0,0 +1,96 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// A held touch while the interpolation scale factor is changed (/s) :
+//  - the active tiles & the output frame are cleared
+//  - the track is kept : same UID, pressed in every frame, at the same position (blobs coordinates are given in the SCALE_X scale)
+//  - the lift gives a released frame (state 0, last state 1) for the held UID
+
+#include "config.h"
+#include "interp.h"
+#include "blob.h"
+#include "host_test.h"
+
+#define TOUCH_X     5.3f
+#define TOUCH_Y     9.6f
+
+uint8_t testRaw[RAW_FRAME];
+
+static void draw_touch(float cx, float cy, float amplitude, float sigma) {
+  for (int y = 0; y < RAW_ROWS; y++) {
+    for (int x = 0; x < RAW_COLS; x++) {
+      float dist = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      int val = testRaw[y * RAW_COLS + x] + (int)(amplitude * expf(-dist / (2 * sigma * sigma)));
+      testRaw[y * RAW_COLS + x] = constrain(val, 0, 255);
+    }
+  }
+}
+
+// Return the number of frames the track was not pressed
+static int run_frames(image_t* rawFrame_ptr, image_t* interpFrame_ptr, tracks_t* tracks_ptr, int frames, uint8_t id) {
+  int released = 0;
+  for (int frame = 0; frame < frames; frame++) {
+    frameTime += 5000;
+    interp_matrix(rawFrame_ptr);
+    find_blobs(10, interpFrame_ptr, &interpActiveTiles[0], tracks_ptr);
+    if (!(tracks_ptr->liveMask & (1ULL << id)) || !TRACK_GET_STATE(tracks_ptr, id)) released++;
+  }
+  return released;
+}
+
+static boolean tiles_cleared(void) {
+  for (int row = 0; row < RAW_ROWS; row++) {
+    if (interpActiveTiles[row]) return false;
+  }
+  return true;
+}
+
+int main(void) {
+  image_t rawFrame = {testRaw, RAW_COLS, RAW_ROWS};
+  image_t interpFrame;
+  tracks_t tracks;
+  INTERP_SETUP(&interpFrame);
+  BLOB_SETUP(&tracks);
+
+  memset(testRaw, 0, sizeof(testRaw));
+  draw_touch(TOUCH_X, TOUCH_Y, 120, 1.0f);
+  run_frames(&rawFrame, &interpFrame, &tracks, 20, 0);
+  CHECK(__builtin_popcountll(tracks.liveMask) == 1);
+  uint8_t id = __builtin_ctzll(tracks.liveMask);
+  float refX = tracks.X[id];
+  float refY = tracks.Y[id];
+
+  const uint8_t scales[] = {2, 8, 1, SCALE_X};
+  for (uint8_t i = 0; i < sizeof(scales); i++) {
+    CHECK(interp_set_scale(scales[i], &interpFrame));
+    CHECK(tiles_cleared());
+    CHECK(interpFrame.numCols == RAW_COLS * scales[i]);
+    CHECK(run_frames(&rawFrame, &interpFrame, &tracks, 20, id) == 0);
+    CHECK(tracks.liveMask == (1ULL << id));
+    float err = sqrtf((tracks.X[id] - refX) * (tracks.X[id] - refX) + (tracks.Y[id] - refY) * (tracks.Y[id] - refY));
+    printf("Scale %d : UID %d kept, position error %.2f px\n", scales[i], id, err);
+    CHECK(err < 0.5f * SCALE_X);
+  }
+  CHECK(!interp_set_scale(3, &interpFrame));
+  CHECK(!interp_set_scale(16, &interpFrame));
+
+  // Lift : the cleared dirty tiles reference leaves no stale cells, the held UID is released
+  memset(testRaw, 0, sizeof(testRaw));
+  run_frames(&rawFrame, &interpFrame, &tracks, 1, id);
+  boolean blank = true;
+  for (int i = 0; i < interpFrame.numCols * interpFrame.numRows; i++) {
+    if (interpFrame.pData[i]) blank = false;
+  }
+  CHECK(blank);
+  boolean releaseSeen = false;
+  for (int frame = 0; frame < 20 && (tracks.liveMask & (1ULL << id)); frame++) {
+    if (!TRACK_GET_STATE(&tracks, id) && TRACK_GET_LAST_STATE(&tracks, id)) releaseSeen = true;
+    run_frames(&rawFrame, &interpFrame, &tracks, 1, id);
+  }
+  CHECK(releaseSeen);
+  CHECK(tracks.liveMask == 0);
+  return TEST_RESULT();
+}
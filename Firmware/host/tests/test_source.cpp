@@ -0,0 +1,58 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// FRAME_SOURCE_REPLAY : the frames.e256 records written with the documented layout are read back unchanged
+
+#include "config.h"
+#include "source.h"
+#include "blob.h"
+#include "host_test.h"
+
+#define TEST_FILE     "test_source.e256"
+#define TEST_FRAMES   3
+
+static const uint32_t testTimes[TEST_FRAMES] = {0, 0x01020304, 0xF0000010};
+
+static uint8_t test_value(int frame, int row, int col) {
+  return (uint8_t)(frame * 31 + row * 7 + col * 3);
+}
+
+int main(void) {
+  FILE* file = fopen(TEST_FILE, "wb");
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    uint32_t time = testTimes[frame];
+    uint8_t header[4] = {(uint8_t)time, (uint8_t)(time >> 8), (uint8_t)(time >> 16), (uint8_t)(time >> 24)};
+    fwrite(header, sizeof(header), 1, file);
+    for (int row = 0; row < RAW_ROWS; row++) {
+      for (int col = 0; col < RAW_COLS; col++) {
+        fputc(test_value(frame, row, col), file);
+      }
+    }
+  }
+  fclose(file);
+
+  image_t rawFrame;
+  replayPath = TEST_FILE;
+  SOURCE_SETUP(&rawFrame);
+  CHECK(replayFile != NULL);
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    CHECK(read_frame(&rawFrame));
+    CHECK(frameTime == testTimes[frame]);
+    CHECK(source_micros() == testTimes[frame]);
+    int errors = 0;
+    for (int row = 0; row < RAW_ROWS; row++) {
+      uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(&rawFrame, row);
+      for (int col = 0; col < RAW_COLS; col++) {
+        if (row_ptr[col] != test_value(frame, row, col)) errors++;
+      }
+    }
+    CHECK(errors == 0);
+  }
+  CHECK(!read_frame(&rawFrame));   // REPLAY_LOOP is 0 on the host
+  CHECK(replayFile == NULL);
+  remove(TEST_FILE);
+  return TEST_RESULT();
+}
@@ -0,0 +1,163 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+// Replay of 60 s at 200 fps : three touches on fast Lissajous paths, lifted in turns
+// Counts the ID switches per minute (a touch given another UID while it stays down) :
+//  - after : the tracks UIDs (optimal assignment, blobs_tracking())
+//  - before : the former per-blob nearest match (2 pixels cutoff, smallest free UID) run on the same blobs positions
+
+#include "config.h"
+#include "interp.h"
+#include "blob.h"
+#include "host_test.h"
+
+#define TEST_FRAMES     12000 // 60 s at 200 fps
+#define TOUCHES         3
+#define NEAREST_CUTOFF  2     // Former match distance (pixels)
+#define NO_UID          0xFF
+
+uint8_t testRaw[RAW_FRAME];
+
+static void draw_touch(float cx, float cy, float amplitude, float sigma) {
+  for (int y = 0; y < RAW_ROWS; y++) {
+    for (int x = 0; x < RAW_COLS; x++) {
+      float dist = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+      int val = testRaw[y * RAW_COLS + x] + (int)(amplitude * expf(-dist / (2 * sigma * sigma)));
+      testRaw[y * RAW_COLS + x] = constrain(val, 0, 255);
+    }
+  }
+}
+
+typedef struct {
+  uint8_t count;
+  float X[MAX_BLOBS];
+  float Y[MAX_BLOBS];
+  uint8_t UID[MAX_BLOBS];
+} ids_t;
+
+static boolean uid_used(ids_t* blobs_ptr, uint8_t uid) {
+  for (uint8_t i = 0; i < blobs_ptr->count; i++) {
+    if (blobs_ptr->UID[i] == uid) return true;
+  }
+  return false;
+}
+
+// Former tracking : each blob takes the UID of the nearest last frame blob closer than NEAREST_CUTOFF
+// or the smallest UID not used by the last frame blobs
+static void nearest_match(ids_t* last_ptr, ids_t* blobs_ptr) {
+  for (uint8_t i = 0; i < blobs_ptr->count; i++) {
+    float minDist = 255.0f;
+    uint8_t nearest = NO_UID;
+    for (uint8_t j = 0; j < last_ptr->count; j++) {
+      float dist = hypotf(blobs_ptr->X[i] - last_ptr->X[j], blobs_ptr->Y[i] - last_ptr->Y[j]);
+      if (dist < minDist) {
+        minDist = dist;
+        nearest = j;
+      }
+    }
+    if (minDist < NEAREST_CUTOFF) {
+      blobs_ptr->UID[i] = last_ptr->UID[nearest];
+    }
+    else {
+      uint8_t minID = 0;
+      while (uid_used(last_ptr, minID)) minID++;
+      blobs_ptr->UID[i] = minID;
+    }
+  }
+}
+
+// UID of the blob closest to the touch (one raw cell), NO_UID if the touch is not visible (merged)
+static uint8_t touch_uid(ids_t* blobs_ptr, float posX, float posY) {
+  float minDist = SCALE_X;
+  uint8_t uid = NO_UID;
+  for (uint8_t i = 0; i < blobs_ptr->count; i++) {
+    float dist = hypotf(blobs_ptr->X[i] - posX, blobs_ptr->Y[i] - posY);
+    if (dist < minDist) {
+      minDist = dist;
+      uid = blobs_ptr->UID[i];
+    }
+  }
+  return uid;
+}
+
+static void count_switch(uint8_t uid, uint8_t* lastUID_ptr, int* switches_ptr) {
+  if (uid == NO_UID) return;
+  if (*lastUID_ptr != NO_UID && uid != *lastUID_ptr) (*switches_ptr)++;
+  *lastUID_ptr = uid;
+}
+
+int main(void) {
+  image_t rawFrame = {testRaw, RAW_COLS, RAW_ROWS};
+  image_t interpFrame;
+  tracks_t tracks;
+  INTERP_SETUP(&interpFrame);
+  BLOB_SETUP(&tracks);
+
+  srand(7);
+  float phase[TOUCHES];
+  float freqX[TOUCHES];
+  float freqY[TOUCHES];
+  float speed[TOUCHES];
+  uint8_t lastTrackUID[TOUCHES];
+  uint8_t lastNearestUID[TOUCHES];
+  for (int k = 0; k < TOUCHES; k++) {
+    phase[k] = (rand() % 628) / 100.0f;
+    freqX[k] = 0.5f + (rand() % 100) / 100.0f;
+    freqY[k] = 0.5f + (rand() % 100) / 100.0f;
+    speed[k] = 0.02f + (rand() % 60) / 1000.0f;
+    lastTrackUID[k] = NO_UID;
+    lastNearestUID[k] = NO_UID;
+  }
+
+  ids_t lastBlobs = {};
+  int trackSwitches = 0;
+  int nearestSwitches = 0;
+  for (int frame = 0; frame < TEST_FRAMES; frame++) {
+    float posX[TOUCHES];
+    float posY[TOUCHES];
+    boolean down[TOUCHES];
+    memset(testRaw, 0, sizeof(testRaw));
+    for (int k = 0; k < TOUCHES; k++) {
+      float t = frame * speed[k];
+      posX[k] = 7.5f + 6 * sinf(freqX[k] * t + phase[k]);
+      posY[k] = 7.5f + 6 * sinf(freqY[k] * t);
+      down[k] = ((frame / 400 + k) % 5) != 0;
+      if (down[k]) draw_touch(posX[k], posY[k], 110, 0.8f);
+    }
+    frameTime += 5000;
+    interp_matrix(&rawFrame);
+    find_blobs(10, &interpFrame, &interpActiveTiles[0], &tracks);
+
+    // The blobs of the frame : the found live & pending tracks
+    ids_t tracked = {};
+    ids_t nearest = {};
+    for (uint64_t mask = tracks.liveMask | tracks.pendingMask; mask; mask &= mask - 1) {
+      uint8_t id = __builtin_ctzll(mask);
+      if (tracks.flags[id] & (TRACK_NOT_FOUND | TRACK_MERGED)) continue;
+      tracked.X[tracked.count] = nearest.X[nearest.count] = tracks.X[id];
+      tracked.Y[tracked.count] = nearest.Y[nearest.count] = tracks.Y[id];
+      tracked.UID[tracked.count++] = id;
+      nearest.count++;
+    }
+    nearest_match(&lastBlobs, &nearest);
+    lastBlobs = nearest;
+
+    for (int k = 0; k < TOUCHES; k++) {
+      if (!down[k]) {
+        lastTrackUID[k] = NO_UID;
+        lastNearestUID[k] = NO_UID;
+        continue;
+      }
+      count_switch(touch_uid(&tracked, posX[k] * SCALE_X, posY[k] * SCALE_Y), &lastTrackUID[k], &trackSwitches);
+      count_switch(touch_uid(&nearest, posX[k] * SCALE_X, posY[k] * SCALE_Y), &lastNearestUID[k], &nearestSwitches);
+    }
+  }
+  float minutes = TEST_FRAMES / (200.0f * 60);
+  printf("ID switches per minute : nearest match %.0f, optimal assignment %.0f\n", nearestSwitches / minutes, trackSwitches / minutes);
+  CHECK(nearestSwitches > 0);
+  CHECK(trackSwitches * 2 < nearestSwitches);
+  return TEST_RESULT();
+}
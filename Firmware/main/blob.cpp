@@ -11,23 +11,76 @@
 */
 
 #include "blob.h"
+#include "interp.h"
 
-#define MAX_BLOBS           32            // [1:64] Set how many blobs can be tracked at the same time
 #define LIFO_NODES          512           // Set the maximum nodes number
-#define X_STRIDE            3             // Speed up the scanning X
-#define Y_STRIDE            3             // Speed up the scanning Y
 #define MIN_BLOB_PIX        5             // Set the minimum blob pixels
-#define DEBOUNCE_TIME       20            // Avioding undesired bouncing effect when taping on the sensor
+#define MERGE_GRACE_TIME    1000          // Set the maximum time (ms) a merged track is kept hidden in its parent track (BLOB_LINEAGE)
+#define UID_REUSE_DELAY     100           // [0:1000] Set the minimum time (ms) before a released UID is given to a new blob (0 to disable)
+#define UID_ALL_MASK        ((MAX_BLOBS < 64) ? ((1ULL << MAX_BLOBS) - 1) : ~0ULL)
+#define NO_UID              0xFF
+#define LOW_THRESHOLD(z)    ((z) - MIN((z), (uint8_t)BLOB_HYSTERESIS)) // The blobs are grown & kept above this threshold
+#define MAX_RUNS            1024          // [1:65535] Set the maximum runs number (RUN_LENGTH_UNION_FIND)
+#define MAX_LABELS          64            // [1:254] Set the maximum labels number (RUN_LENGTH_UNION_FIND)
+#define NO_LABEL            0xFF
+#define TRACK_GATE          (1.0f * SCALE_X)  // Maximum distance between a blob and its predicted position (one raw cell)
+#define TRACK_SPLIT_GATE    (2.0f * SCALE_X)  // Maximum distance between a new blob and the predicted position of a merged track
+#define TRACK_GATE_VELOCITY 1.5f          // Gate increase per pixel of predicted displacement since the last frame
+#define TRACK_ALPHA         0.6f          // [0:1] Alpha-beta filter position gain
+#define TRACK_BETA          0.2f          // [0:1] Alpha-beta filter velocity gain
+#define TRACK_COST_SCALE    16            // Squared distances to integer costs (1/4 pixel resolution)
+#define TRACK_NO_MATCH      0x00FFFFFF    // Cost of an assignment outside the gate
+#define TRACK_INF           0x7FFFFFFF
+#define MAX_ROW_RUNS        (MAX_NEW_COLS / 2) // Maximum runs in a row (BLOB_STREAMING)
+#define SPLIT_PEAKS         4             // [2:255] Set the maximum pressure peaks per blob (BLOB_SPLIT)
+
+#define ROW_WORDS           ((BLOB_LABELLER == RUN_LENGTH_UNION_FIND) || DEBUG_BLOB_BENCH || BLOB_STREAMING)
+
+#if BLOB_SPLIT && ((BLOB_LABELLER != RUN_LENGTH_UNION_FIND) || BLOB_STREAMING || RAW_BLOBS)
+#error "BLOB_SPLIT is only available with the RUN_LENGTH_UNION_FIND labeller"
+#endif
 
 #define CENTER_X            (NEW_COLS / 2)
 #define CENTER_Y            (NEW_ROWS / 2)
 
-uint8_t bitmapFrame[NEW_FRAME] = {0};     // 1D Array to store (64*64) binary values
+#if (BLOB_LABELLER == SCANLINE_FLOOD_FILL) || DEBUG_BLOB_BENCH
+uint8_t bitmapArray[SIZEOF_BITMAP(MAX_NEW_COLS, MAX_NEW_ROWS)] = {0}; // 1D Array to store (64*64) binary values (sized for MAX_SCALE)
+image_t bitmapFrame = {&bitmapArray[0], NEW_COLS, NEW_ROWS};
+#endif
 xylr_t lifoArray[LIFO_NODES] = {0};       // 1D Array to store lifo nodes
-blob_t blobArray[MAX_BLOBS] = {0};        // 1D Array to store blobs
+blob_t blobArray[MAX_BLOBS] = {0};        // 1D Array to store the blobs found in a frame
+int32_t costArray[MAX_BLOBS][MAX_BLOBS] = {0}; // 2D Array to store the input blobs to tracks assignment costs
+uint32_t assignmentTime = 0;              // Duration of the last frame blobs to tracks assignment (micros)
+#if UID_REUSE_DELAY
+uint64_t uidCooldownMask = 0;             // One bit per UID released less than UID_REUSE_DELAY ago
+uint32_t uidReleaseTime[MAX_BLOBS] = {0}; // 1D Array to store the UIDs release time (frameTime)
+#endif
+
+#if (BLOB_LABELLER == RUN_LENGTH_UNION_FIND) || DEBUG_BLOB_BENCH
+uint32_t thresholdArray[WORDS_PER_ROW(MAX_NEW_COLS) * MAX_NEW_ROWS] = {0}; // 1D Array to store the thresholded frame, one bit per pixel packed in row words
+run_t runArray[MAX_RUNS] = {};           // 1D Array to store the rows runs
+#endif
+
+#if BLOB_SPLIT
+peak_t peakArray[MAX_LABELS][SPLIT_PEAKS] = {}; // 2D Array to store the pressure peaks of each label
+uint8_t peakCount[MAX_LABELS] = {0};      // 1D Array to store the pressure peaks count of each label
+uint8_t splitLabel[MAX_LABELS] = {0};     // 1D Array to store the first new label of each split label
+#endif
+
+#if ROW_WORDS
+label_t labelArray[MAX_LABELS] = {};     // 1D Array to store the labels statistics
+#endif
 
-velocity_t blobVelocity[MAX_SYNTH] = {0}; // 1D Array to store XY & Z blobs velocity
-polar_t polarCoord[MAX_SYNTH] = {0};      // 1D Array of struct polar_t to store blobs polar coordinates
+#if BLOB_STREAMING
+uint8_t streamRowArray[MAX_NEW_COLS] = {0};                 // 1D Array to store one interpolated row
+uint32_t streamWordsArray[WORDS_PER_ROW(MAX_NEW_COLS)] = {0}; // 1D Array to store one thresholded row
+run_t streamRunArray[2][MAX_ROW_RUNS] = {0};                // 2D Array to store the current & previous row runs
+#endif
+
+#if RAW_BLOBS
+uint8_t rawLifoArray[RAW_FRAME] = {0};    // 1D Array to store the raw cells to visit (index)
+uint16_t rawBitmap[RAW_ROWS] = {0};       // One uint16_t per raw row, one bit per visited cell
+#endif
 
 llist_t llist_context_stack;              // Free nodes stack
 llist_t llist_context;                    // Used nodes
@@ -48,319 +101,827 @@ void lifo_llist_init(llist_t* llist_ptr, xylr_t* nodesArray_ptr) {
   }
 }
 
-void BLOB_SETUP(llist_t* blobs_ptr) {
+void BLOB_SETUP(tracks_t* tracks_ptr) {
   lifo_llist_init(&llist_context_stack, &lifoArray[0]); // Add X nodes to the llist_context_stack
   blob_llist_init(&llist_blobs_stack, &blobArray[0]); // Add X nodes to the llist_blobs_stack linked list
   llist_raz(&llist_context);
   llist_raz(&llist_blobs);
-  llist_raz(blobs_ptr);
+  memset(tracks_ptr, 0, sizeof(tracks_t));
+#if UID_REUSE_DELAY
+  uidCooldownMask = 0;
+#endif
 }
 
-/////////////////////////////// Scanline flood fill algorithm / SFF
-/////////////////////////////// Connected-component labeling / CCL
-void find_blobs(uint8_t zThreshold, image_t* inputFrame_ptr, llist_t* outputBlobs_ptr) {
+/////////////////////////////// BLOBS UID
+// The UID of a track is its slot index in the tracks table, the smallest free slot is given with count trailing zeros
+// A released UID is not given again before UID_REUSE_DELAY unless no other UID is free
+// The UID of a pending track is free at once (it was never sent)
+static void uid_release(tracks_t* tracks_ptr, uint8_t UID) {
+#if UID_REUSE_DELAY
+  if (tracks_ptr->liveMask & (1ULL << UID)) {
+    uidCooldownMask |= 1ULL << UID;
+    uidReleaseTime[UID] = frameTime;
+  }
+#endif
+  tracks_ptr->liveMask &= ~(1ULL << UID);
+  tracks_ptr->pendingMask &= ~(1ULL << UID);
+}
 
-  memset((uint8_t*)bitmapFrame, 0, SIZEOF_FRAME);
+// The new track is pending until its birth is confirmed (BLOB_BIRTH_FRAMES)
+// Return NO_UID if all the slots are used (the blob is dropped until a slot is released)
+static uint8_t uid_alloc(tracks_t* tracks_ptr) {
+  uint64_t usedMask = tracks_ptr->liveMask | tracks_ptr->pendingMask;
+#if UID_REUSE_DELAY
+  uint64_t cooldown = uidCooldownMask;
+  while (cooldown) {
+    uint8_t UID = __builtin_ctzll(cooldown);
+    cooldown &= cooldown - 1;
+    if ((frameTime - uidReleaseTime[UID]) >= UID_REUSE_DELAY * 1000UL) {
+      uidCooldownMask &= ~(1ULL << UID);
+    }
+  }
+  uint64_t freeMask = ~usedMask & ~uidCooldownMask & UID_ALL_MASK;
+  if (!freeMask) freeMask = ~usedMask & UID_ALL_MASK;
+#else
+  uint64_t freeMask = ~usedMask & UID_ALL_MASK;
+#endif
+  if (!freeMask) return NO_UID;
+  uint8_t UID = __builtin_ctzll(freeMask);
+  tracks_ptr->pendingMask |= 1ULL << UID;
+  return UID;
+}
 
-  for (uint8_t posY = 0; posY < NEW_ROWS; posY += Y_STRIDE) {
+/////////////////////////////// BLOBS FILTER
+// Constant velocity alpha-beta filter updated with the frames scan time (frameTime)
+// pos, vel, depth & depthRate are the filter state (pixels & pixels per second), X, Y & D are the filtered output
+static void blob_filter_init(tracks_t* tracks_ptr, uint8_t id, blob_t* blob_ptr) {
+  tracks_ptr->timeStamp[id] = frameTime;
+  tracks_ptr->posX[id] = blob_ptr->centroid.X;
+  tracks_ptr->posY[id] = blob_ptr->centroid.Y;
+  tracks_ptr->velX[id] = 0;
+  tracks_ptr->velY[id] = 0;
+  tracks_ptr->depth[id] = blob_ptr->box.D;
+  tracks_ptr->depthRate[id] = 0;
+  tracks_ptr->X[id] = blob_ptr->centroid.X;
+  tracks_ptr->Y[id] = blob_ptr->centroid.Y;
+  tracks_ptr->D[id] = blob_ptr->box.D;
+}
 
-    uint8_t* row_ptr_A = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY);
-    uint8_t* bmp_row_ptr_A = COMPUTE_BINARY_IMAGE_ROW_PTR(&bitmapFrame[0], posY);
+// blob_ptr : the new measure of the track id
+static void blob_filter_update(tracks_t* tracks_ptr, uint8_t id, blob_t* blob_ptr) {
+  float dt = (frameTime - tracks_ptr->timeStamp[id]) * 1e-6f;
+  float predX = tracks_ptr->posX[id] + tracks_ptr->velX[id] * dt;
+  float predY = tracks_ptr->posY[id] + tracks_ptr->velY[id] * dt;
+  float predZ = tracks_ptr->depth[id] + tracks_ptr->depthRate[id] * dt;
+  float rX = blob_ptr->centroid.X - predX;
+  float rY = blob_ptr->centroid.Y - predY;
+  float rZ = blob_ptr->box.D - predZ;
+  tracks_ptr->posX[id] = predX + TRACK_ALPHA * rX;
+  tracks_ptr->posY[id] = predY + TRACK_ALPHA * rY;
+  tracks_ptr->depth[id] = predZ + TRACK_ALPHA * rZ;
+  if (dt > 0) {
+    tracks_ptr->velX[id] += TRACK_BETA * rX / dt;
+    tracks_ptr->velY[id] += TRACK_BETA * rY / dt;
+    tracks_ptr->depthRate[id] += TRACK_BETA * rZ / dt;
+  }
+  tracks_ptr->timeStamp[id] = frameTime;
+  tracks_ptr->X[id] = tracks_ptr->posX[id];
+  tracks_ptr->Y[id] = tracks_ptr->posY[id];
+  tracks_ptr->D[id] = constrain(lround(tracks_ptr->depth[id]), 0, 255);
+}
 
-    for (uint8_t posX = (posY % X_STRIDE); posX < NEW_COLS; posX += X_STRIDE) {
-      if (!IMAGE_GET_BINARY_PIXEL_FAST(bmp_row_ptr_A, posX)
-          && PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr_A, posX), zThreshold)) {
+// Predict the tracks centroids forward to the given time (micros) to hide the scan to output latency
+void blobs_predict(tracks_t* tracks_ptr, uint32_t time) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    float dt = (time - tracks_ptr->timeStamp[id]) * 1e-6f;
+    tracks_ptr->X[id] = tracks_ptr->posX[id] + tracks_ptr->velX[id] * dt;
+    tracks_ptr->Y[id] = tracks_ptr->posY[id] + tracks_ptr->velY[id] * dt;
+  }
+}
 
-        uint8_t oldX = posX;
-        uint8_t oldY = posY;
+/////////////////////////////// BLOBS ASSIGNMENT
+// Hungarian algorithm (O(n^3) with the rows & columns potentials) on the square costArray [size x size]
+// match[row] : the column assigned to each row
+static void blobs_assignment(uint8_t size, int8_t* match_ptr) {
+  int32_t u[MAX_BLOBS + 1] = {0};      // Rows potentials
+  int32_t v[MAX_BLOBS + 1] = {0};      // Columns potentials
+  int32_t minv[MAX_BLOBS + 1];
+  uint8_t p[MAX_BLOBS + 1] = {0};      // Row assigned to each column (1 based, 0 is free)
+  uint8_t way[MAX_BLOBS + 1] = {0};
+  boolean used[MAX_BLOBS + 1];
+
+  for (uint8_t i = 1; i <= size; i++) {
+    p[0] = i;
+    uint8_t j0 = 0;
+    for (uint8_t j = 0; j <= size; j++) {
+      minv[j] = TRACK_INF;
+      used[j] = false;
+    }
+    do {
+      used[j0] = true;
+      uint8_t i0 = p[j0];
+      uint8_t j1 = 0;
+      int32_t delta = TRACK_INF;
+      for (uint8_t j = 1; j <= size; j++) {
+        if (!used[j]) {
+          int32_t cur = costArray[i0 - 1][j - 1] - u[i0] - v[j];
+          if (cur < minv[j]) {
+            minv[j] = cur;
+            way[j] = j0;
+          }
+          if (minv[j] < delta) {
+            delta = minv[j];
+            j1 = j;
+          }
+        }
+      }
+      for (uint8_t j = 0; j <= size; j++) {
+        if (used[j]) {
+          u[p[j]] += delta;
+          v[j] -= delta;
+        }
+        else {
+          minv[j] -= delta;
+        }
+      }
+      j0 = j1;
+    } while (p[j0] != 0);
+    do {
+      uint8_t j1 = way[j0];
+      p[j0] = p[j1];
+      j0 = j1;
+    } while (j0);
+  }
+  for (uint8_t j = 1; j <= size; j++) {
+    if (p[j]) match_ptr[p[j] - 1] = j - 1;
+  }
+}
 
-        uint8_t blob_x1 = posX;
-        uint8_t blob_x2 = posX;
+// Greedy nearest match (O(n^2)) on the costArray [inCount x outCount], used above BLOB_ASSIGNMENT_MAX
+// Each input blob takes its nearest free track within the gate
+static void blobs_nearest(uint8_t inCount, uint8_t outCount, int8_t* match_ptr) {
+  uint64_t usedMask = 0;
+  for (uint8_t i = 0; i < inCount; i++) {
+    int32_t minCost = TRACK_NO_MATCH;
+    int8_t nearest = -1;
+    for (uint8_t j = 0; j < outCount; j++) {
+      if (!((usedMask >> j) & 1) && costArray[i][j] < minCost) {
+        minCost = costArray[i][j];
+        nearest = j;
+      }
+    }
+    match_ptr[i] = nearest;
+    if (nearest >= 0) usedMask |= 1ULL << nearest;
+  }
+}
 
-        uint8_t blob_height = 0;
-        uint8_t blob_depth = 0;
+#if BLOB_LINEAGE
+/////////////////////////////// BLOBS LINEAGE
+// A lost track whose predicted position is inside the equivalent ellipse of a found track blob is merged:
+// it stays pressed but hidden (not matched) and follows its parent track with its offset at the merge time
+// A new blob near the predicted position of a merged track gives it back its UID: the track is split
+// The merged tracks are released with their parent track or MERGE_GRACE_TIME after their last detection
+static void track_event(tracks_t* tracks_ptr, uint8_t type, uint8_t parent, uint8_t child) {
+  if (tracks_ptr->eventCount < MAX_TRACK_EVENTS) {
+    track_event_t* event_ptr = &tracks_ptr->events[tracks_ptr->eventCount++];
+    event_ptr->type = type;
+    event_ptr->parent = parent;
+    event_ptr->child = child;
+  }
+}
 
-        uint16_t blob_pixels = 0;
-        uint16_t blob_cx = 0;
-        uint16_t blob_cy = 0;
+// Squared distance of the position to the center of an equivalent ellipse, normalised by the ellipse radius (inside if < 1)
+static float ellipse_dist(float major, float minor, float angle, float dx, float dy) {
+  float c = cosf(angle);
+  float s = sinf(angle);
+  float u = (dx * c + dy * s) / (major / 2 + 1);
+  float v = (dy * c - dx * s) / (minor / 2 + 1);
+  return u * u + v * v;
+}
 
-        while (1) { // while_A
-          uint8_t left = posX;
-          uint8_t right = posX;
+// Return the track that have the nearest equivalent ellipse containing the position (NO_UID if none)
+static uint8_t track_ellipse_find(tracks_t* tracks_ptr, uint64_t tracksMask, float posX, float posY) {
+  uint8_t parent = NO_UID;
+  float minDist = 1.0f;
+  for (uint64_t mask = tracksMask; mask; mask &= mask - 1) {
+    uint8_t id = __builtin_ctzll(mask);
+    float dist = ellipse_dist(tracks_ptr->major[id], tracks_ptr->minor[id], tracks_ptr->angle[id],
+                              posX - tracks_ptr->posX[id], posY - tracks_ptr->posY[id]);
+    if (dist < minDist) {
+      minDist = dist;
+      parent = id;
+    }
+  }
+  return parent;
+}
 
-          uint8_t* row_ptr_B = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY);
-          uint8_t* bmp_row_ptr_B = COMPUTE_BINARY_IMAGE_ROW_PTR (&bitmapFrame[0], posY);
+// Return the lost track predicted the nearest from the blob inside its equivalent ellipse (NO_UID if none)
+// The blob is the merge of this track and of the other lost tracks inside its ellipse
+static uint8_t track_merge_blob(tracks_t* tracks_ptr, uint64_t lostMask, blob_t* blob_ptr) {
+  uint8_t parent = NO_UID;
+  float minDist = 1.0f;
+  for (uint64_t lost = lostMask; lost; lost &= lost - 1) {
+    uint8_t id = __builtin_ctzll(lost);
+    float dt = (frameTime - tracks_ptr->timeStamp[id]) * 1e-6f;
+    float dx = tracks_ptr->posX[id] + tracks_ptr->velX[id] * dt - blob_ptr->centroid.X;
+    float dy = tracks_ptr->posY[id] + tracks_ptr->velY[id] * dt - blob_ptr->centroid.Y;
+    float dist = ellipse_dist(blob_ptr->ellipse.major, blob_ptr->ellipse.minor, blob_ptr->ellipse.angle, dx, dy);
+    if (dist < minDist) {
+      minDist = dist;
+      parent = id;
+    }
+  }
+  return parent;
+}
 
-          while ((left > 0)
-                 && (!IMAGE_GET_BINARY_PIXEL_FAST(bmp_row_ptr_B, left - 1))
-                 && PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr_B, left - 1), zThreshold)) {
-            left--;
-          }
+// Return the merged track predicted the nearest from the blob within TRACK_SPLIT_GATE (NO_UID if none)
+static uint8_t track_split_child(tracks_t* tracks_ptr, uint64_t mergedMask, blob_t* blob_ptr) {
+  uint8_t child = NO_UID;
+  float minDist = TRACK_SPLIT_GATE * TRACK_SPLIT_GATE;
+  for (uint64_t merged = mergedMask; merged; merged &= merged - 1) {
+    uint8_t id = __builtin_ctzll(merged);
+    float dt = (frameTime - tracks_ptr->timeStamp[id]) * 1e-6f;
+    float dx = blob_ptr->centroid.X - (tracks_ptr->posX[id] + tracks_ptr->velX[id] * dt);
+    float dy = blob_ptr->centroid.Y - (tracks_ptr->posY[id] + tracks_ptr->velY[id] * dt);
+    float dist = dx * dx + dy * dy;
+    if (dist < minDist) {
+      minDist = dist;
+      child = id;
+    }
+  }
+  return child;
+}
 
-          while (right < (NEW_COLS - 1)
-                 && (!IMAGE_GET_BINARY_PIXEL_FAST(bmp_row_ptr_B, right + 1))
-                 && PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr_B, right + 1), zThreshold)) {
-            right++;
-          }
+static float blob_dist(tracks_t* tracks_ptr, uint8_t id, blob_t* blob_ptr) {
+  float dx = blob_ptr->centroid.X - tracks_ptr->posX[id];
+  float dy = blob_ptr->centroid.Y - tracks_ptr->posY[id];
+  return dx * dx + dy * dy;
+}
+#endif
 
-          blob_x1 = MIN(blob_x1, left);
-          blob_x2 = MAX(blob_x2, right);
+/////////////////////////////// PERSISTANT BLOB ID
+// Match the llist_blobs found in the current frame to the live & pending tracks of the tracks table
+// and update the matched tracks, give the new blobs a free slot
+// zSeed : seed threshold above the labelling threshold, a new blob must be above it (the found blobs can keep their track down to the low threshold)
+// The blobs depth is given above the seed threshold, clamped at 0
+// A new track is pressed after BLOB_BIRTH_FRAMES frames and released after BLOB_DEATH_FRAMES & BLOB_DEATH_TIME without blob
+static void blobs_tracking(tracks_t* tracks_ptr, uint8_t zSeed) {
+
+  tracks_ptr->eventCount = 0; // The events are given for the current frame only
+
+  // Free the tracks released in the last frame
+  for (uint64_t live = tracks_ptr->liveMask | tracks_ptr->pendingMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    if (tracks_ptr->flags[id] & TRACK_TO_REMOVE) {
+      uid_release(tracks_ptr, id);
+      //Serial.printf("\nDEBUG_FIND_BLOBS / Track: %d removed from the **tracks** table", id);
+    }
+  }
 
-          for (uint8_t i = left; i <= right; i++) {
-            IMAGE_SET_BINARY_PIXEL_FAST(bmp_row_ptr_B, i);
-            blob_depth = MAX(blob_depth, IMAGE_GET_PIXEL_FAST(row_ptr_B, i));
-          }
+  // NEW BLOBS MANAGMENT
+  // Look for corresponding blobs into the **inputBlobs** linked list and the **tracks** table
+  // The blobs are matched with an optimal assignment on the squared distances to the predicted positions (alpha-beta filter)
+  // Above BLOB_ASSIGNMENT_MAX blobs or tracks, the greedy nearest match bounds the assignment time
+  uint32_t assignmentStart = micros();
+  blob_t* inBlobs[MAX_BLOBS];
+  uint8_t outTracks[MAX_BLOBS];
+  uint8_t inCount = 0;
+  uint8_t outCount = 0;
+  uint64_t mergedMask = 0;
+  for (blob_t* blobIn = (blob_t*)ITERATOR_START_FROM_HEAD(&llist_blobs); blobIn != NULL; blobIn = (blob_t*)ITERATOR_NEXT(blobIn)) {
+    blobIn->box.D = (blobIn->box.D > zSeed) ? blobIn->box.D - zSeed : 0;
+    inBlobs[inCount++] = blobIn;
+  }
+  for (uint64_t live = tracks_ptr->liveMask | tracks_ptr->pendingMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    if (tracks_ptr->flags[id] & TRACK_MERGED) {
+      mergedMask |= 1ULL << id;
+    }
+    else {
+      outTracks[outCount++] = id;
+    }
+  }
+  uint8_t size = MAX(inCount, outCount);
+  for (uint8_t i = 0; i < size; i++) {
+    for (uint8_t j = 0; j < size; j++) {
+      costArray[i][j] = TRACK_NO_MATCH;
+      if (i < inCount && j < outCount) {
+        uint8_t id = outTracks[j];
+        float dt = (frameTime - tracks_ptr->timeStamp[id]) * 1e-6f;
+        float moveX = tracks_ptr->velX[id] * dt;
+        float moveY = tracks_ptr->velY[id] * dt;
+        float gate = TRACK_GATE + TRACK_GATE_VELOCITY * sqrtf(moveX * moveX + moveY * moveY);
+        float dx = inBlobs[i]->centroid.X - (tracks_ptr->posX[id] + moveX);
+        float dy = inBlobs[i]->centroid.Y - (tracks_ptr->posY[id] + moveY);
+        float dist = dx * dx + dy * dy;
+        if (dist < gate * gate) {
+          costArray[i][j] = (int32_t)(dist * TRACK_COST_SCALE);
+        }
+      }
+    }
+  }
+  int8_t match[MAX_BLOBS];
+  if (size > BLOB_ASSIGNMENT_MAX) {
+    blobs_nearest(inCount, outCount, &match[0]);
+  }
+  else {
+    blobs_assignment(size, &match[0]);
+  }
+  assignmentTime = micros() - assignmentStart;
+#if DEBUG_FIND_BLOBS
+  Serial.printf("\nDEBUG_FIND_BLOBS / Assignment of %d input blobs & %d tracks: %dus", inCount, outCount, assignmentTime);
+#endif
 
-          uint16_t sum = ((right * (right + 1)) - (left * (left - 1))) / 2;
+  // Give each found track its blob: the matched tracks, the split tracks, then the new tracks
+  blob_t* trackBlob[MAX_BLOBS];
+  uint64_t foundMask = 0;
+  uint64_t newMask = 0;
+  uint64_t initMask = 0;
+  for (uint8_t i = 0; i < inCount; i++) {
+    int8_t j = match[i];
+    // If the input blob is matched within the gate of a track: update the track
+    if (j >= 0 && j < outCount && costArray[i][j] != TRACK_NO_MATCH) {
+      uint8_t id = outTracks[j];
+#if DEBUG_FIND_BLOBS
+      Serial.printf("\nDEBUG_FIND_BLOBS / Found corresponding track: %d in the **tracks** table", id);
+#endif
+      trackBlob[id] = inBlobs[i];
+      foundMask |= 1ULL << id;
+      inBlobs[i] = NULL;
+    }
+  }
+  for (uint8_t i = 0; i < inCount; i++) {
+    blob_t* blobIn = inBlobs[i];
+    if (blobIn == NULL) continue;
+    uint8_t id;
+#if BLOB_LINEAGE
+    // A merged track went out of its parent track blob: give it back its UID
+    id = track_split_child(tracks_ptr, mergedMask, blobIn);
+    if (id != NO_UID) {
+      uint8_t parent = tracks_ptr->parent[id];
+#if DEBUG_FIND_BLOBS
+      Serial.printf("\nDEBUG_FIND_BLOBS / Track: %d split from track: %d", id, parent);
+#endif
+      mergedMask &= ~(1ULL << id);
+      tracks_ptr->flags[id] &= ~TRACK_MERGED;
+      track_event(tracks_ptr, TRACK_EVENT_SPLIT, parent, id);
+      trackBlob[id] = blobIn;
+      // The parent track may have been matched to the split track blob (both blobs are near the merged centroid)
+      if ((foundMask & (1ULL << parent)) && blob_dist(tracks_ptr, id, trackBlob[parent]) < blob_dist(tracks_ptr, id, blobIn)) {
+        trackBlob[id] = trackBlob[parent];
+        trackBlob[parent] = blobIn;
+      }
+      foundMask |= 1ULL << id;
+      initMask |= 1ULL << id;
+      continue;
+    }
+    // The blob is inside the last blob of a lost track (the track blob was split)
+    // or the blob is the merge of lost tracks: the nearest one is kept (the others are merged into it)
+    uint64_t lostMask = tracks_ptr->liveMask & ~foundMask & ~mergedMask;
+    id = track_ellipse_find(tracks_ptr, lostMask, blobIn->centroid.X, blobIn->centroid.Y);
+    if (id == NO_UID) id = track_merge_blob(tracks_ptr, lostMask, blobIn);
+    if (id != NO_UID) {
+      trackBlob[id] = blobIn;
+      foundMask |= 1ULL << id;
+      initMask |= 1ULL << id;
+      continue;
+    }
+#endif
+    // Found a new blob! We nead to give it a UID
+    if (blobIn->box.D <= 0) continue; // Not above the seed threshold
+#if DEBUG_FIND_BLOBS
+    Serial.print("\nDEBUG_FIND_BLOBS / Found new blob without ID");
+#endif
+    id = uid_alloc(tracks_ptr);
+    if (id == NO_UID) continue;
+    trackBlob[id] = blobIn;
+    foundMask |= 1ULL << id;
+    newMask |= 1ULL << id;
+  }
 
-          uint8_t pixels = right - left + 1;
-          blob_pixels += pixels;
-          blob_cx += sum;
-          blob_cy += posY * pixels;
+  for (uint64_t found = foundMask; found; found &= found - 1) {
+    uint8_t id = __builtin_ctzll(found);
+    blob_t* blobIn = trackBlob[id];
+    if (newMask & (1ULL << id)) {
+      tracks_ptr->age[id] = 0;
+    }
+    else if (tracks_ptr->age[id] < UINT16_MAX) {
+      tracks_ptr->age[id]++;
+    }
+    tracks_ptr->missed[id] = 0;
+    // A pending track is pressed when it have been found BLOB_BIRTH_FRAMES frames in a row
+    if (tracks_ptr->pendingMask & (1ULL << id)) {
+      if (tracks_ptr->age[id] + 1 >= BLOB_BIRTH_FRAMES) {
+        tracks_ptr->pendingMask &= ~(1ULL << id);
+        tracks_ptr->liveMask |= 1ULL << id;
+        tracks_ptr->flags[id] = TRACK_STATE;
+      }
+      else {
+        tracks_ptr->flags[id] = 0;
+      }
+    }
+    else {
+      tracks_ptr->flags[id] = TRACK_STATE | TRACK_LAST_STATE;
+    }
+    // The split & merged tracks filter is initialised with their new blob
+    if ((newMask | initMask) & (1ULL << id)) {
+      blob_filter_init(tracks_ptr, id, blobIn);
+    }
+    else {
+      blob_filter_update(tracks_ptr, id, blobIn);
+    }
+    tracks_ptr->timeTag[id] = blobIn->timeTag;
+    tracks_ptr->pixels[id] = blobIn->pixels;
+    tracks_ptr->mass[id] = blobIn->mass;
+    tracks_ptr->W[id] = blobIn->box.W;
+    tracks_ptr->H[id] = blobIn->box.H;
+    tracks_ptr->major[id] = blobIn->ellipse.major;
+    tracks_ptr->minor[id] = blobIn->ellipse.minor;
+    tracks_ptr->angle[id] = blobIn->ellipse.angle;
+  }
+  llist_save_nodes(&llist_blobs_stack, &llist_blobs);  // Rescure all input blobs Linked list nodes
 
-          uint8_t top_left = left;
-          uint8_t bot_left = left;
+  // DEAD BLOBS MANAGMENT
+  // A pending track not found in this frame is released (it was never pressed)
+  for (uint64_t lost = tracks_ptr->pendingMask & ~foundMask; lost; lost &= lost - 1) {
+    tracks_ptr->flags[__builtin_ctzll(lost)] = TRACK_TO_REMOVE;
+  }
+  // Look for the live tracks not found in this frame
+  // If not found since BLOB_DEATH_FRAMES & BLOB_DEATH_TIME release it: flag it TO_REMOVE
+  for (uint64_t lost = tracks_ptr->liveMask & ~foundMask & ~mergedMask; lost; lost &= lost - 1) {
+    uint8_t id = __builtin_ctzll(lost);
+#if BLOB_LINEAGE
+    // The lost track is inside a found track blob: hide it in this track
+    float dt = (frameTime - tracks_ptr->timeStamp[id]) * 1e-6f;
+    float predX = tracks_ptr->posX[id] + tracks_ptr->velX[id] * dt;
+    float predY = tracks_ptr->posY[id] + tracks_ptr->velY[id] * dt;
+    uint8_t parent = track_ellipse_find(tracks_ptr, foundMask & tracks_ptr->liveMask, predX, predY);
+    if (parent != NO_UID) {
+#if DEBUG_FIND_BLOBS
+      Serial.printf("\nDEBUG_FIND_BLOBS / Track: %d merged into track: %d", id, parent);
+#endif
+      tracks_ptr->flags[id] |= TRACK_MERGED;
+      tracks_ptr->parent[id] = parent;
+      tracks_ptr->offsetX[id] = predX - tracks_ptr->posX[parent];
+      tracks_ptr->offsetY[id] = predY - tracks_ptr->posY[parent];
+      track_event(tracks_ptr, TRACK_EVENT_MERGE, parent, id);
+      // The tracks hidden in the merged track are now hidden in its parent track
+      for (uint64_t merged = mergedMask; merged; merged &= merged - 1) {
+        uint8_t child = __builtin_ctzll(merged);
+        if (tracks_ptr->parent[child] == id) {
+          tracks_ptr->parent[child] = parent;
+          tracks_ptr->offsetX[child] += tracks_ptr->offsetX[id];
+          tracks_ptr->offsetY[child] += tracks_ptr->offsetY[id];
+        }
+      }
+      mergedMask |= 1ULL << id;
+      continue;
+    }
+#endif
+    tracks_ptr->flags[id] |= TRACK_NOT_FOUND;
+    if (tracks_ptr->age[id] < UINT16_MAX) tracks_ptr->age[id]++;
+    if (tracks_ptr->missed[id] < UINT8_MAX) tracks_ptr->missed[id]++;
+    if (tracks_ptr->missed[id] >= BLOB_DEATH_FRAMES && (frameTime - tracks_ptr->timeStamp[id]) >= BLOB_DEATH_TIME) {
+      tracks_ptr->flags[id] &= ~TRACK_STATE;
+      tracks_ptr->flags[id] |= TRACK_TO_REMOVE;
+      //Serial.printf("\nDEBUG_FIND_BLOBS / Track: %d in the **tracks** table taged TO_REMOVE", id);
+    }
+  }
 
-          boolean break_out = false;
+#if BLOB_LINEAGE
+  // The merged tracks stay pressed and follow their parent track
+  for (uint64_t merged = mergedMask; merged; merged &= merged - 1) {
+    uint8_t id = __builtin_ctzll(merged);
+    uint8_t parent = tracks_ptr->parent[id];
+    if (tracks_ptr->age[id] < UINT16_MAX) tracks_ptr->age[id]++;
+    if ((tracks_ptr->flags[parent] & TRACK_TO_REMOVE) || (frameTime - tracks_ptr->timeTag[id]) > MERGE_GRACE_TIME * 1000UL) {
+      tracks_ptr->flags[id] &= ~(TRACK_STATE | TRACK_MERGED);
+      tracks_ptr->flags[id] |= TRACK_TO_REMOVE;
+      continue;
+    }
+    tracks_ptr->flags[id] = TRACK_STATE | TRACK_LAST_STATE | TRACK_MERGED;
+    tracks_ptr->timeStamp[id] = tracks_ptr->timeStamp[parent];
+    tracks_ptr->posX[id] = tracks_ptr->posX[parent] + tracks_ptr->offsetX[id];
+    tracks_ptr->posY[id] = tracks_ptr->posY[parent] + tracks_ptr->offsetY[id];
+    tracks_ptr->velX[id] = tracks_ptr->velX[parent];
+    tracks_ptr->velY[id] = tracks_ptr->velY[parent];
+    tracks_ptr->depth[id] = tracks_ptr->depth[parent];
+    tracks_ptr->depthRate[id] = tracks_ptr->depthRate[parent];
+    tracks_ptr->X[id] = tracks_ptr->posX[id];
+    tracks_ptr->Y[id] = tracks_ptr->posY[id];
+    tracks_ptr->D[id] = tracks_ptr->D[parent];
+  }
+#endif
 
-          while (1) { // while_B
+#if DEBUG_BLOBS
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    Serial.printf("\nDEBUG_FIND_BLOBS:%d\tLS:%d\tS:%d\tX:%f\tY:%f\tW:%d\tH:%d\tD:%d\t",
+                  id,
+                  TRACK_GET_LAST_STATE(tracks_ptr, id),
+                  TRACK_GET_STATE(tracks_ptr, id),
+                  tracks_ptr->X[id],
+                  tracks_ptr->Y[id],
+                  tracks_ptr->W[id],
+                  tracks_ptr->H[id],
+                  tracks_ptr->D[id]
+                 );
+  }
+#endif
+};
 
-            if (posY > 0) {
-              row_ptr_B = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY - 1);
-              bmp_row_ptr_B = COMPUTE_BINARY_IMAGE_ROW_PTR(&bitmapFrame[0], posY - 1);
+/////////////////////////////// BLOBS FEATURES
+// Integer (pixel - zThreshold) weighted moments accumulated run by run while labelling
+// and finalised once per blob into the weighted centroid, exact box, mass & equivalent ellipse
+static void run_moments(run_t* run_ptr, uint8_t* row_ptr, uint8_t zThreshold) {
+  uint16_t w = 0;
+  uint32_t wx = 0;
+  uint32_t wxx = 0;
+  uint8_t depth = 0;
+  for (uint16_t x = run_ptr->x1; x <= run_ptr->x2; x++) {
+    uint8_t pixel = IMAGE_GET_PIXEL_FAST(row_ptr, x);
+    uint16_t weight = pixel - zThreshold;
+    w += weight;
+    wx += weight * x;
+    wxx += weight * x * x;
+    depth = MAX(depth, pixel);
+  };
+  run_ptr->w = w;
+  run_ptr->wx = wx;
+  run_ptr->wxx = wxx;
+  run_ptr->depth = depth;
+};
 
-              boolean recurse = false;
-              for (uint8_t i = top_left; i <= right; i++) {
+static void label_init(label_t* label_ptr) {
+  memset(label_ptr, 0, sizeof(label_t));
+  label_ptr->x1 = 0xFF;
+  label_ptr->y1 = 0xFF;
+};
 
-                if ((!IMAGE_GET_BINARY_PIXEL_FAST(bmp_row_ptr_B, i))
-                    && (PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr_B, i), zThreshold))) {
+static void label_add_run(label_t* label_ptr, run_t* run_ptr) {
+  uint8_t posY = run_ptr->y;
+  label_ptr->pixels += run_ptr->x2 - run_ptr->x1 + 1;
+  label_ptr->m += run_ptr->w;
+  label_ptr->mx += run_ptr->wx;
+  label_ptr->my += run_ptr->w * posY;
+  label_ptr->mxx += run_ptr->wxx;
+  label_ptr->myy += (uint32_t)run_ptr->w * posY * posY;
+  label_ptr->mxy += (uint64_t)run_ptr->wx * posY;
+  label_ptr->x1 = MIN(label_ptr->x1, run_ptr->x1);
+  label_ptr->x2 = MAX(label_ptr->x2, run_ptr->x2);
+  label_ptr->y1 = MIN(label_ptr->y1, posY);
+  label_ptr->y2 = MAX(label_ptr->y2, posY);
+  label_ptr->depth = MAX(label_ptr->depth, run_ptr->depth);
+};
 
-                  xylr_t* context = (xylr_t*)llist_pop_front(&llist_context_stack);
-                  //Serial.printf("\nDEBUG_LIFO / A / llist_context_stack / llist_pop_front: %p", (lnode_t*)context);
+#if BLOB_STREAMING
+static void label_merge(label_t* root_ptr, label_t* label_ptr) {
+  root_ptr->pixels += label_ptr->pixels;
+  root_ptr->m += label_ptr->m;
+  root_ptr->mx += label_ptr->mx;
+  root_ptr->my += label_ptr->my;
+  root_ptr->mxx += label_ptr->mxx;
+  root_ptr->myy += label_ptr->myy;
+  root_ptr->mxy += label_ptr->mxy;
+  root_ptr->x1 = MIN(root_ptr->x1, label_ptr->x1);
+  root_ptr->x2 = MAX(root_ptr->x2, label_ptr->x2);
+  root_ptr->y1 = MIN(root_ptr->y1, label_ptr->y1);
+  root_ptr->y2 = MAX(root_ptr->y2, label_ptr->y2);
+  root_ptr->depth = MAX(root_ptr->depth, label_ptr->depth);
+};
+#endif
 
-                  context->x = posX;
-                  context->y = posY;
-                  context->l = left;
-                  context->r = right;
-                  context->t_l = i++; // Don't test the same pixel again
-                  context->b_l = bot_left;
+// posScale : from the label pixels to the SCALE_X scale
+// Return NULL if the llist_blobs_stack is empty
+static blob_t* label_to_blob(label_t* label_ptr, uint8_t zThreshold, float posScale) {
+  if (llist_blobs_stack.head_ptr == NULL) return NULL;
+  blob_t* blob = (blob_t*)llist_pop_front(&llist_blobs_stack);
+
+  float cx = label_ptr->mx / (float)label_ptr->m;
+  float cy = label_ptr->my / (float)label_ptr->m;
+  float varX = label_ptr->mxx / (float)label_ptr->m - cx * cx;
+  float varY = label_ptr->myy / (float)label_ptr->m - cy * cy;
+  float covXY = label_ptr->mxy / (float)label_ptr->m - cx * cy;
+  float delta = sqrtf((varX - varY) * (varX - varY) * 0.25f + covXY * covXY);
+
+  blob->timeTag = frameTime;
+  blob->pixels = label_ptr->pixels * posScale * posScale;
+  blob->mass = label_ptr->m * posScale * posScale;
+  blob->centroid.X = cx * posScale;
+  blob->centroid.Y = cy * posScale;
+  blob->box.W = (label_ptr->x2 - label_ptr->x1 + 1) * posScale;
+  blob->box.H = (label_ptr->y2 - label_ptr->y1 + 1) * posScale;
+  blob->box.D = label_ptr->depth - zThreshold; // Rebased on the seed threshold by blobs_tracking()
+  blob->ellipse.major = 4 * sqrtf(MAX((varX + varY) * 0.5f + delta, 0.0f)) * posScale;
+  blob->ellipse.minor = 4 * sqrtf(MAX((varX + varY) * 0.5f - delta, 0.0f)) * posScale;
+  blob->ellipse.angle = 0.5f * atan2f(2 * covXY, varX - varY);
+  llist_push_front(&llist_blobs, blob);
+  return blob;
+};
 
-                  llist_push_front(&llist_context, context);
-                  //Serial.printf("\nDEBUG_LIFO / A / llist_context / llist_push_front: %p", (lnode_t*)context);
+/////////////////////////////// Scanline flood fill algorithm / SFF
+/////////////////////////////// Connected-component labeling / CCL
+// Blobs are seeded from the tracks predicted positions first (touches move little between two scans)
+// then all the active tiles are swept at full resolution (the labelled pixels are skipped), all others pixels are null
+// The cost follows the touched pixels & the active tiles, not the frame size
+#if (BLOB_LABELLER == SCANLINE_FLOOD_FILL) || DEBUG_BLOB_BENCH
+// Fill the blob of the seed pixel (if not yet labelled) and accumulate its runs into a new blob
+static void blob_flood_fill(uint8_t zThreshold, image_t* inputFrame_ptr, uint8_t posX, uint8_t posY) {
+
+  uint8_t numCols = inputFrame_ptr->numCols;
+  uint8_t scale = numCols / RAW_COLS;
+  uint16_t minBlobPix = MIN_BLOB_PIX * scale * scale / (SCALE_X * SCALE_Y);
+  float posScale = SCALE_X / (float)scale;
+
+  if (IMAGE_GET_BINARY_PIXEL_FAST(COMPUTE_BINARY_IMAGE_ROW_PTR(&bitmapFrame, posY), posX)
+      || !PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY), posX), zThreshold)) {
+    return;
+  }
 
-                  posX = i;
-                  posY--;
-                  recurse = true;
-                  break;
-                }
-              }
-              if (recurse) {
-                break;
-              }
-            }
+  label_t blob_label;
+  label_init(&blob_label);
 
-            row_ptr_B = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY + 1);
-            bmp_row_ptr_B = COMPUTE_BINARY_IMAGE_ROW_PTR(&bitmapFrame[0], posY + 1);
+  while (1) { // while_A
+    uint8_t left = posX;
+    uint8_t right = posX;
 
-            boolean recurse = false;
-            for (uint8_t i = bot_left; i <= right; i++) {
+    uint8_t* row_ptr_B = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY);
+    uint8_t* bmp_row_ptr_B = COMPUTE_BINARY_IMAGE_ROW_PTR(&bitmapFrame, posY);
 
-              if (!IMAGE_GET_BINARY_PIXEL_FAST(bmp_row_ptr_B, i)
-                  && PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr_B, i), zThreshold)) {
+    while ((left > 0)
+           && (!IMAGE_GET_BINARY_PIXEL_FAST(bmp_row_ptr_B, left - 1))
+           && PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr_B, left - 1), zThreshold)) {
+      left--;
+    }
+
+    while (right < (numCols - 1)
+           && (!IMAGE_GET_BINARY_PIXEL_FAST(bmp_row_ptr_B, right + 1))
+           && PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr_B, right + 1), zThreshold)) {
+      right++;
+    }
 
-                xylr_t* context = (xylr_t*)llist_pop_front(&llist_context_stack);
-                //Serial.printf("\nDEBUG_LIFO / B / llist_context_stack / llist_pop_front: %p", (lnode_t*)context);
+    for (uint8_t i = left; i <= right; i++) {
+      IMAGE_SET_BINARY_PIXEL_FAST(bmp_row_ptr_B, i);
+    }
 
-                context->x = posX;
-                context->y = posY;
-                context->l = left;
-                context->r = right;
-                context->t_l = top_left;
-                context->b_l = i++; // Don't test the same pixel again
+    run_t run;
+    run.y = posY;
+    run.x1 = left;
+    run.x2 = right;
+    run_moments(&run, row_ptr_B, zThreshold);
+    label_add_run(&blob_label, &run);
 
-                llist_push_front(&llist_context, context);
-                //Serial.printf("\nDEBUG_LIFO / B / llist_context / llist_push_front: %p", (lnode_t*)context);
+    uint8_t top_left = left;
+    uint8_t bot_left = left;
 
-                posX = i;
-                posY++;
-                recurse = true;
-                break;
-              }
-            }
+    boolean break_out = false;
 
-            if (recurse) {
-              break;
-            }
-            if (llist_context.head_ptr == NULL) {
-              break_out = true;
-              break;
-            }
+    while (1) { // while_B
 
-            xylr_t* context = (xylr_t*)llist_pop_front(&llist_context);
-            //Serial.printf("\nDEBUG_LIFO / C / llist_context / llist_pop_front: %p", (lnode_t*)context);
+      if (posY > 0) {
+        row_ptr_B = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY - 1);
+        bmp_row_ptr_B = COMPUTE_BINARY_IMAGE_ROW_PTR(&bitmapFrame, posY - 1);
 
-            posX = context->x;
-            posY = context->y;
-            left = context->l;
-            right = context->r;
-            top_left = context->t_l;
-            bot_left = context->b_l;
+        boolean recurse = false;
+        for (uint8_t i = top_left; i <= right; i++) {
 
-            llist_push_front(&llist_context_stack, context);
-            //Serial.printf("\nDEBUG_LIFO / C / llist_context_stack / llist_push_front: %p", (lnode_t*)context);
+          if ((!IMAGE_GET_BINARY_PIXEL_FAST(bmp_row_ptr_B, i))
+              && (PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr_B, i), zThreshold))) {
 
-            blob_height++;
+            xylr_t* context = (xylr_t*)llist_pop_front(&llist_context_stack);
+            //Serial.printf("\nDEBUG_LIFO / A / llist_context_stack / llist_pop_front: %p", (lnode_t*)context);
+            if (context == NULL) continue; // LIFO_NODES exhausted: this pixel is left unlabelled
 
-          } // END while_B
+            context->x = posX;
+            context->y = posY;
+            context->l = left;
+            context->r = right;
+            context->t_l = i + 1; // Don't test the same pixel again
+            context->b_l = bot_left;
 
-          if (break_out) {
+            llist_push_front(&llist_context, context);
+            //Serial.printf("\nDEBUG_LIFO / A / llist_context / llist_push_front: %p", (lnode_t*)context);
+
+            posX = i;
+            posY--;
+            recurse = true;
             break;
           }
-        } // END while_A
+        }
+        if (recurse) {
+          break;
+        }
+      }
+
+      row_ptr_B = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY + 1);
+      bmp_row_ptr_B = COMPUTE_BINARY_IMAGE_ROW_PTR(&bitmapFrame, posY + 1);
+
+      boolean recurse = false;
+      for (uint8_t i = bot_left; i <= right; i++) {
+
+        if (!IMAGE_GET_BINARY_PIXEL_FAST(bmp_row_ptr_B, i)
+            && PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr_B, i), zThreshold)) {
 
-        if (blob_pixels > MIN_BLOB_PIX) {
+          xylr_t* context = (xylr_t*)llist_pop_front(&llist_context_stack);
+          //Serial.printf("\nDEBUG_LIFO / B / llist_context_stack / llist_pop_front: %p", (lnode_t*)context);
+          if (context == NULL) continue; // LIFO_NODES exhausted: this pixel is left unlabelled
 
-          blob_t* blob = (blob_t*)llist_pop_front(&llist_blobs_stack);
+          context->x = posX;
+          context->y = posY;
+          context->l = left;
+          context->r = right;
+          context->t_l = top_left;
+          context->b_l = i + 1; // Don't test the same pixel again
 
-          blob->timeTag = millis();
-          blob->centroid.X = blob_cx / (float)blob_pixels;
-          blob->centroid.Y = blob_cy / (float)blob_pixels;
-          blob->box.W = (blob_x2 - blob_x1);
-          blob->box.H = blob_height;
-          blob->box.D = blob_depth - zThreshold; // NEED TO ADD A LIMIT?
-          llist_push_front(&llist_blobs, blob);
+          llist_push_front(&llist_context, context);
+          //Serial.printf("\nDEBUG_LIFO / B / llist_context / llist_push_front: %p", (lnode_t*)context);
+
+          posX = i;
+          posY++;
+          recurse = true;
+          break;
         }
-        posX = oldX;
-        posY = oldY;
       }
-    }
-  }
 
-  /////////////////////////////// PERSISTANT BLOB ID
+      if (recurse) {
+        break;
+      }
+      if (llist_context.head_ptr == NULL) {
+        break_out = true;
+        break;
+      }
 
-  // Suppress DEAD blobs from the outputBlobs linked list
-  while (1) {
-    boolean deadFound = false;
-    blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(outputBlobs_ptr);
-    if (blob_ptr != NULL && blob_ptr->status == TO_REMOVE) {
-      deadFound = true;
-      blob_ptr = (blob_t*)llist_pop_front(outputBlobs_ptr);
-      blob_ptr->status = FREE;
-      llist_push_front(&llist_blobs_stack, blob_ptr);
-      //Serial.printf("\nDEBUG_FIND_BLOBS / Blob: %p removed from **outputBlobs** linked list", (lnode_t*)blob_ptr);
-    }
-    if (!deadFound) {
+      xylr_t* context = (xylr_t*)llist_pop_front(&llist_context);
+      //Serial.printf("\nDEBUG_LIFO / C / llist_context / llist_pop_front: %p", (lnode_t*)context);
+
+      posX = context->x;
+      posY = context->y;
+      left = context->l;
+      right = context->r;
+      top_left = context->t_l;
+      bot_left = context->b_l;
+
+      llist_push_front(&llist_context_stack, context);
+      //Serial.printf("\nDEBUG_LIFO / C / llist_context_stack / llist_push_front: %p", (lnode_t*)context);
+
+    } // END while_B
+
+    if (break_out) {
       break;
     }
+  } // END while_A
+
+  if (blob_label.pixels > minBlobPix) {
+    label_to_blob(&blob_label, zThreshold, posScale);
   }
+}
 
-  // NEW BLOBS MANAGMENT
-  // Look for corresponding blobs into the **inputBlobs** and **outputBlobs** linked list
-  for (blob_t* blobIn = (blob_t*)ITERATOR_START_FROM_HEAD(&llist_blobs); blobIn != NULL; blobIn = (blob_t*)ITERATOR_NEXT(blobIn)) {
-    float minDist = 255.0f;
-    blob_t* nearestBlob = NULL;
-    for (blob_t* blobOut = (blob_t*)ITERATOR_START_FROM_HEAD(outputBlobs_ptr); blobOut != NULL; blobOut = (blob_t*)ITERATOR_NEXT(blobOut)) {
-      float dist = sqrtf(pow(blobIn->centroid.X - blobOut->centroid.X, 2) + pow(blobIn->centroid.Y - blobOut->centroid.Y, 2));
-#if DEBUG_FIND_BLOBS
-      Serial.printf("\nDEBUG_FIND_BLOBS / Distance between input & output blobs positions: %f ", dist);
-#endif
-      if (dist < minDist) {
-        minDist = dist;
-        nearestBlob = blobOut;
+// tracks_ptr : the tracks used as seeds (NULL to sweep the active tiles only)
+static void blobs_flood_fill(uint8_t zThreshold, image_t* inputFrame_ptr, uint16_t* activeTiles_ptr, tracks_t* tracks_ptr) {
+
+  // The interpolation scale factor can be changed at runtime
+  // Minimum blob size follows it, blobs coordinates are given in the SCALE_X scale
+  uint8_t numCols = inputFrame_ptr->numCols;
+  uint8_t numRows = inputFrame_ptr->numRows;
+  uint8_t scale = numCols / RAW_COLS;
+  float posScale = SCALE_X / (float)scale;
+
+  bitmapFrame.numCols = numCols;
+  bitmapFrame.numRows = numRows;
+  memset((uint8_t*)bitmapArray, 0, SIZEOF_BITMAP(numCols, numRows));
+
+  // Seed the fills from the tracks predicted positions
+  if (tracks_ptr != NULL) {
+    for (uint64_t live = tracks_ptr->liveMask | tracks_ptr->pendingMask; live; live &= live - 1) {
+      uint8_t id = __builtin_ctzll(live);
+      if (tracks_ptr->flags[id] & TRACK_MERGED) continue;
+      float dt = (frameTime - tracks_ptr->timeStamp[id]) * 1e-6f;
+      int16_t posX = lroundf((tracks_ptr->posX[id] + tracks_ptr->velX[id] * dt) / posScale);
+      int16_t posY = lroundf((tracks_ptr->posY[id] + tracks_ptr->velY[id] * dt) / posScale);
+      if (posX < 0 || posX >= numCols || posY < 0 || posY >= numRows) continue;
+      if ((activeTiles_ptr[posY / scale] >> (posX / scale)) & 1) {
+        blob_flood_fill(zThreshold, inputFrame_ptr, posX, posY);
       }
     }
-    // If the distance between curent blob and last blob position is less than minDist:
-    // Give the nearestBlob UID to the input blob.
-    if (minDist < 2) {
-#if DEBUG_FIND_BLOBS
-      Serial.printf("\nDEBUG_FIND_BLOBS / Found corresponding blob: %p in the **outputBlobs** linked list", (lnode_t*)nearestBlob);
-#endif
-      blobIn->UID = nearestBlob->UID;
-      blobIn->lastState = true;
-      blobIn->state = true;
-    }
-    // Found a new blob! We nead to give it a UID
-    else {
-#if DEBUG_FIND_BLOBS
-      Serial.print("\nDEBUG_FIND_BLOBS / Found new blob without ID");
-#endif
-      // Find the smallest missing UID in the outputBlobs linked list
-      uint8_t minID = 0;
-      while (1) {
-        boolean isFree = true;
-        for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(outputBlobs_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-          if (blob_ptr->UID == minID) {
-            isFree = false;
-            minID++;
-            break;
-          }
-        }
-        if (isFree) {
-          blobIn->UID = minID;
-          blobIn->lastState = false;
-          blobIn->state = true;
-          break;
-        }
-      } // while_end / The blob have a new ID
-    }
   }
 
-  // DEAD BLOBS MANAGMENT
-  // Look for dead blobs in the outputBlobs linked list
-  // If found flag it TO_REMOVE
-  while (1) {
-    boolean allDone = true;
-    blob_t* prevBlob_ptr = NULL;
-    for (blob_t* blobOut = (blob_t*)ITERATOR_START_FROM_HEAD(outputBlobs_ptr); blobOut != NULL; blobOut = (blob_t*)ITERATOR_NEXT(blobOut)) {
-      boolean found = false;
-      for (blob_t* blobIn = (blob_t*)ITERATOR_START_FROM_HEAD(&llist_blobs); blobIn != NULL; blobIn = (blob_t*)ITERATOR_NEXT(blobIn)) {
-        if (blobOut->UID == blobIn->UID) {
-          found = true;
-          break;
-        }
-      }
-      if (!found) {
-        allDone = false;
-        llist_extract_node(outputBlobs_ptr, prevBlob_ptr, blobOut);
-        blobOut->status = NOT_FOUND;
-        //Serial.printf("\nDEBUG_FIND_BLOBS / Blob: %p in the **outputBlobs** linked list is NOT_FOUND", (lnode_t*)blobOut);
-        if ((millis() - blobOut->timeTag) > DEBOUNCE_TIME) {
-          blobOut->state = false;
-          blobOut->status = TO_REMOVE;
-          //Serial.printf("\nDEBUG_FIND_BLOBS / Blob: %p in the **outputBlobs** linked list taged TO_REMOVE", (lnode_t*)blobOut);
+  // Sweep all the active tiles at full resolution, a tile crossed by a seeded blob can hold another touch
+  for (uint8_t rowPos = 0; rowPos < RAW_ROWS; rowPos++) {
+    for (uint16_t rowTiles = activeTiles_ptr[rowPos]; rowTiles; rowTiles &= rowTiles - 1) {
+      uint8_t colPos = __builtin_ctz(rowTiles);
+      for (uint8_t posY = rowPos * scale; posY < (rowPos + 1) * scale; posY++) {
+        for (uint8_t posX = colPos * scale; posX < (colPos + 1) * scale; posX++) {
+          blob_flood_fill(zThreshold, inputFrame_ptr, posX, posY);
         }
-        llist_push_front(&llist_blobs, blobOut);
-        break;
       }
-      prevBlob_ptr = blobOut;
-    }
-    if (allDone) {
-      break;
     }
   }
 
-  llist_swap_llist(outputBlobs_ptr, &llist_blobs);     // Swap inputBlobs with outputBlobs linked list
-  llist_save_nodes(&llist_blobs_stack, &llist_blobs);  // Rescure all dead blobs Linked list nodes
-
-#if DEBUG_BLOBS
-  for (blob_t* blob = (blob_t*)ITERATOR_START_FROM_HEAD(outputBlobs_ptr); blob != NULL; blob = (blob_t*)ITERATOR_NEXT(blob)) {
-    Serial.printf("\nDEBUG_FIND_BLOBS:%d\tLS:%d\tS:%d\tX:%f\tY:%f\tW:%d\tH:%d\tD:%d\t",
-                  blob->UID,
-                  blob->lastState,
-                  blob->state,
-                  blob->centroid.X,
-                  blob->centroid.Y,
-                  blob->box.W,
-                  blob->box.H,
-                  blob->box.D
-                 );
-  }
-#endif
-
 #if DEBUG_BITMAP
-  for (uint8_t posY = 0; posY < NEW_ROWS; posY++) {
-    uint8_t* row_ptr = COMPUTE_BINARY_IMAGE_ROW_PTR(&bitmapFrame[0], posY);
-    for (uint8_t posX = 0; posX < NEW_COLS; posX++) {
+  for (uint8_t posY = 0; posY < numRows; posY++) {
+    uint8_t* row_ptr = COMPUTE_BINARY_IMAGE_ROW_PTR(&bitmapFrame, posY);
+    for (uint8_t posX = 0; posX < numCols; posX++) {
       IMAGE_GET_BINARY_PIXEL_FAST(row_ptr, posX) == 0 ? Serial.printf(".") : Serial.printf("o");
     }
     Serial.printf("\n");
@@ -368,54 +929,542 @@ void find_blobs(uint8_t zThreshold, image_t* inputFrame_ptr, llist_t* outputBlob
   Serial.printf("\n");
 #endif
 }
+#endif
 
-void getBlobsVelocity(llist_t* blobs_ptr) {
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(blobs_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-    if (blob_ptr->UID < MAX_SYNTH) {
-      float vx = blob_ptr->centroid.X - blobVelocity[blob_ptr->UID].lastPos.X;
-      float vy = blob_ptr->centroid.Y - blobVelocity[blob_ptr->UID].lastPos.Y;
+#if ROW_WORDS
+// Pack the pixels of a row above the zThreshold into row words (one bit per pixel)
+static void threshold_row(uint8_t* row_ptr, uint8_t numCols, uint8_t zThreshold, uint32_t* bin_row_ptr) {
+  for (uint8_t word = 0; word < WORDS_PER_ROW(numCols); word++) {
+    uint8_t* pixel_ptr = &row_ptr[word << UINT32_T_SHIFT];
+    uint8_t count = MIN((uint8_t)UINT32_T_BITS, (uint8_t)(numCols - (word << UINT32_T_SHIFT)));
+    uint32_t bits = 0;
+    for (uint8_t i = 0; i < count; i++) {
+      bits |= (uint32_t)PIXEL_THRESHOLD(pixel_ptr[i], zThreshold) << i;
+    };
+    bin_row_ptr[word] = bits;
+  };
+};
 
-      blobVelocity[blob_ptr->UID].vxy = sqrt(vx * vx + vy * vy); //pow(vx, 2) + pow(vy, 2)
-      blobVelocity[blob_ptr->UID].vz = blob_ptr->box.D - blobVelocity[blob_ptr->UID].lvz;
+// Position of the first set bit (first clear bit with invert = 0xFFFFFFFF) from posX, numCols if none
+static uint8_t bitmap_scan(uint32_t* row_ptr, uint8_t posX, uint8_t numCols, uint32_t invert) {
+  uint8_t word = posX >> UINT32_T_SHIFT;
+  uint8_t words = WORDS_PER_ROW(numCols);
+  uint32_t bits = (row_ptr[word] ^ invert) & (0xFFFFFFFF << (posX & UINT32_T_MASK));
+  while (!bits) {
+    if (++word >= words) return numCols;
+    bits = row_ptr[word] ^ invert;
+  };
+  return MIN(numCols, (uint8_t)((word << UINT32_T_SHIFT) + __builtin_ctz(bits)));
+};
+#endif
 
-      blobVelocity[blob_ptr->UID].lastPos.X = blob_ptr->centroid.X;
-      blobVelocity[blob_ptr->UID].lastPos.Y = blob_ptr->centroid.Y;
-      blobVelocity[blob_ptr->UID].lvz = blob_ptr->box.D;
+/////////////////////////////// Run-length union-find / RLUF
+/////////////////////////////// Connected-component labeling / CCL
+// Threshold pass : pack the pixels above the zThreshold into row words
+// First pass : extract the runs with count trailing zeros on the row words
+// and merge them with the overlapping runs of the previous row (4-connectivity)
+// Second pass : accumulate the blobs statistics into the label of each run root
+// Runs & labels are bounded by MAX_RUNS & MAX_LABELS, the remaining ones are ignored
+#if (BLOB_LABELLER == RUN_LENGTH_UNION_FIND) || DEBUG_BLOB_BENCH
+static uint16_t run_find(uint16_t index) {
+  while (runArray[index].parent != index) {
+    runArray[index].parent = runArray[runArray[index].parent].parent; // Path halving
+    index = runArray[index].parent;
+  };
+  return index;
+};
 
-#if DEBUG_MAPPING
-      Serial.printf("\nDEBUG_VELOCITY:\tvxy:%f\tvz:%f",
-                    blobVelocity[blob_ptr->UID].vxy,
-                    blobVelocity[blob_ptr->UID].vz
-                   );
+#if BLOB_SPLIT
+/////////////////////////////// Merged blobs split
+// The pressure peaks of each label are its local maxima (8-neighbourhood) on the interpolated frame
+// A peak is kept if the frame drops by BLOB_SPLIT_PROMINENCE on the line to each higher kept peak
+// The pixels of a label with more than one peak are given to the nearest peak (its runs are cut into sub-runs)
+// and their moments are accumulated into new labels, the split label is emptied
+// The cost is bounded by the labelled pixels, SPLIT_PEAKS & MAX_LABELS
+static boolean pixel_is_peak(image_t* frame_ptr, uint8_t posX, uint8_t posY) {
+  uint8_t val = IMAGE_GET_PIXEL_FAST(COMPUTE_IMAGE_ROW_PTR(frame_ptr, posY), posX);
+  for (int8_t dy = -1; dy <= 1; dy++) {
+    if ((posY == 0 && dy < 0) || (posY == frame_ptr->numRows - 1 && dy > 0)) continue;
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(frame_ptr, posY + dy);
+    for (int8_t dx = -1; dx <= 1; dx++) {
+      if ((dx == 0 && dy == 0) || (posX == 0 && dx < 0) || (posX == frame_ptr->numCols - 1 && dx > 0)) continue;
+      uint8_t pixel = IMAGE_GET_PIXEL_FAST(row_ptr, posX + dx);
+      if (pixel > val) return false;
+      if (pixel == val && (dy < 0 || (dy == 0 && dx < 0))) return false; // Plateaus: only keep the first pixel
+    };
+  };
+  return true;
+};
+
+// Keep the SPLIT_PEAKS highest peaks, sorted by decreasing value
+static void peak_insert(peak_t* peaks_ptr, uint8_t* count_ptr, uint8_t posX, uint8_t posY, uint8_t val) {
+  uint8_t pos = *count_ptr;
+  if (pos == SPLIT_PEAKS) {
+    if (val <= peaks_ptr[SPLIT_PEAKS - 1].val) return;
+    pos--;
+  }
+  else {
+    (*count_ptr)++;
+  };
+  while (pos > 0 && peaks_ptr[pos - 1].val < val) {
+    peaks_ptr[pos] = peaks_ptr[pos - 1];
+    pos--;
+  };
+  peaks_ptr[pos].x = posX;
+  peaks_ptr[pos].y = posY;
+  peaks_ptr[pos].val = val;
+};
+
+// Minimum frame value on the line between two peaks
+static uint8_t peak_saddle(image_t* frame_ptr, peak_t* peakA_ptr, peak_t* peakB_ptr) {
+  int16_t dx = peakB_ptr->x - peakA_ptr->x;
+  int16_t dy = peakB_ptr->y - peakA_ptr->y;
+  uint8_t steps = MAX(abs(dx), abs(dy));
+  uint8_t saddle = MIN(peakA_ptr->val, peakB_ptr->val);
+  for (uint8_t i = 1; i < steps; i++) {
+    uint8_t posX = peakA_ptr->x + lroundf((float)(dx * i) / steps);
+    uint8_t posY = peakA_ptr->y + lroundf((float)(dy * i) / steps);
+    saddle = MIN(saddle, IMAGE_GET_PIXEL_FAST(COMPUTE_IMAGE_ROW_PTR(frame_ptr, posY), posX));
+  };
+  return saddle;
+};
+
+static uint8_t peak_nearest(peak_t* peaks_ptr, uint8_t count, uint8_t posX, uint8_t posY) {
+  uint8_t nearest = 0;
+  uint16_t minDist = 0xFFFF;
+  for (uint8_t i = 0; i < count; i++) {
+    int16_t dx = posX - peaks_ptr[i].x;
+    int16_t dy = posY - peaks_ptr[i].y;
+    uint16_t dist = dx * dx + dy * dy;
+    if (dist < minDist) {
+      minDist = dist;
+      nearest = i;
+    };
+  };
+  return nearest;
+};
+
+// Return the new labels count
+static uint8_t blobs_split(uint8_t zThreshold, image_t* inputFrame_ptr, uint16_t runs, uint8_t labels) {
+
+  memset(peakCount, 0, labels);
+
+  // Pressure peaks candidates
+  for (uint16_t i = 0; i < runs; i++) {
+    run_t* run_ptr = &runArray[i];
+    if (run_ptr->label == NO_LABEL) continue;
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, run_ptr->y);
+    for (uint16_t posX = run_ptr->x1; posX <= run_ptr->x2; posX++) {
+      uint8_t val = IMAGE_GET_PIXEL_FAST(row_ptr, posX);
+      if (val - zThreshold >= BLOB_SPLIT_PROMINENCE && pixel_is_peak(inputFrame_ptr, posX, run_ptr->y)) {
+        peak_insert(&peakArray[run_ptr->label][0], &peakCount[run_ptr->label], posX, run_ptr->y, val);
+      };
+    };
+  };
+
+  // Keep the prominent peaks & give the split labels their new labels
+  uint8_t newLabels = labels;
+  for (uint8_t i = 0; i < labels; i++) {
+    peak_t* peaks_ptr = &peakArray[i][0];
+    uint8_t count = MIN(peakCount[i], (uint8_t)1);
+    for (uint8_t j = 1; j < peakCount[i]; j++) {
+      boolean prominent = true;
+      for (uint8_t k = 0; k < count; k++) {
+        if (peaks_ptr[j].val - peak_saddle(inputFrame_ptr, &peaks_ptr[j], &peaks_ptr[k]) < BLOB_SPLIT_PROMINENCE) {
+          prominent = false;
+          break;
+        };
+      };
+      if (prominent) peaks_ptr[count++] = peaks_ptr[j];
+    };
+    splitLabel[i] = NO_LABEL;
+    if (count > 1 && newLabels + count <= MAX_LABELS) {
+      peakCount[i] = count;
+      splitLabel[i] = newLabels;
+      for (uint8_t j = 0; j < count; j++) {
+        label_init(&labelArray[newLabels++]);
+      };
+      labelArray[i].pixels = 0; // The split label is replaced by its parts
+    };
+  };
+
+  // Give the pixels of the split labels to the nearest peak
+  for (uint16_t i = 0; i < runs; i++) {
+    run_t* run_ptr = &runArray[i];
+    if (run_ptr->label == NO_LABEL || splitLabel[run_ptr->label] == NO_LABEL) continue;
+    peak_t* peaks_ptr = &peakArray[run_ptr->label][0];
+    uint8_t count = peakCount[run_ptr->label];
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, run_ptr->y);
+    run_t subRun;
+    subRun.y = run_ptr->y;
+    subRun.x1 = run_ptr->x1;
+    uint8_t peak = peak_nearest(peaks_ptr, count, run_ptr->x1, run_ptr->y);
+    for (uint16_t posX = run_ptr->x1 + 1; posX <= run_ptr->x2 + 1; posX++) {
+      uint8_t nextPeak = (posX <= run_ptr->x2) ? peak_nearest(peaks_ptr, count, posX, run_ptr->y) : NO_LABEL;
+      if (nextPeak != peak) {
+        subRun.x2 = posX - 1;
+        run_moments(&subRun, row_ptr, zThreshold);
+        label_add_run(&labelArray[splitLabel[run_ptr->label] + peak], &subRun);
+        subRun.x1 = posX;
+        peak = nextPeak;
+      };
+    };
+  };
+  return newLabels;
+};
+#endif
+
+static void blobs_union_find(uint8_t zThreshold, image_t* inputFrame_ptr, uint16_t* activeTiles_ptr) {
+
+  uint8_t numCols = inputFrame_ptr->numCols;
+  uint8_t numRows = inputFrame_ptr->numRows;
+  uint8_t scale = numCols / RAW_COLS;
+  uint16_t minBlobPix = MIN_BLOB_PIX * scale * scale / (SCALE_X * SCALE_Y);
+  float posScale = SCALE_X / (float)scale;
+
+  uint8_t words = WORDS_PER_ROW(numCols);
+
+  // Threshold pass : one bit per pixel, packed in row words (rows without active tiles are left empty)
+  for (uint8_t posY = 0; posY < numRows; posY++) {
+    uint32_t* bin_row_ptr = &thresholdArray[posY * words];
+    if (activeTiles_ptr[posY / scale]) {
+      threshold_row(COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY), numCols, zThreshold, bin_row_ptr);
+    }
+    else {
+      memset(bin_row_ptr, 0, words * sizeof(uint32_t));
+    };
+  };
+
+  uint16_t runs = 0;
+  uint16_t lastRowStart = 0;
+  uint16_t lastRowEnd = 0;
+
+  for (uint8_t posY = 0; posY < numRows; posY++) {
+    uint16_t rowStart = runs;
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY);
+    uint32_t* bin_row_ptr = &thresholdArray[posY * words];
+    uint16_t prev = lastRowStart;
+    uint8_t posX = bitmap_scan(bin_row_ptr, 0, numCols, 0);
+
+    while (posX < numCols && runs < MAX_RUNS) {
+      run_t* run_ptr = &runArray[runs];
+      run_ptr->y = posY;
+      run_ptr->x1 = posX;
+      run_ptr->parent = runs;
+      posX = bitmap_scan(bin_row_ptr, posX, numCols, 0xFFFFFFFF); // Run end
+      run_ptr->x2 = posX - 1;
+      run_moments(run_ptr, row_ptr, zThreshold);
+
+      // Merge with the overlapping runs of the previous row, the smallest root index is kept
+      while (prev < lastRowEnd && runArray[prev].x2 < run_ptr->x1) prev++;
+      for (uint16_t i = prev; i < lastRowEnd && runArray[i].x1 <= run_ptr->x2; i++) {
+        uint16_t rootA = run_find(i);
+        uint16_t rootB = run_find(runs);
+        if (rootA < rootB) runArray[rootB].parent = rootA;
+        else if (rootB < rootA) runArray[rootA].parent = rootB;
+      };
+      runs++;
+      if (posX < numCols) posX = bitmap_scan(bin_row_ptr, posX, numCols, 0); // Next run start
+    };
+    lastRowStart = rowStart;
+    lastRowEnd = runs;
+  };
+
+  // A root is always the first run of its blob, so its label is set before its children
+  uint8_t labels = 0;
+  for (uint16_t i = 0; i < runs; i++) {
+    run_t* run_ptr = &runArray[i];
+    uint16_t root = run_find(i);
+    if (root == i) {
+      if (labels == MAX_LABELS) {
+        run_ptr->label = NO_LABEL;
+        continue;
+      };
+      run_ptr->label = labels;
+      label_init(&labelArray[labels++]);
+    }
+    else {
+      run_ptr->label = runArray[root].label;
+      if (run_ptr->label == NO_LABEL) continue;
+    };
+    label_add_run(&labelArray[run_ptr->label], run_ptr);
+  };
+
+#if BLOB_SPLIT
+  labels = blobs_split(zThreshold, inputFrame_ptr, runs, labels);
 #endif
+
+  for (uint8_t i = 0; i < labels; i++) {
+    if (labelArray[i].pixels > minBlobPix) {
+      label_to_blob(&labelArray[i], zThreshold, posScale);
     };
   };
 };
+#endif
+
+// zSeedThreshold : a new blob must reach this threshold, the blobs are labelled above LOW_THRESHOLD(zSeedThreshold)
+// activeTiles_ptr : the interpolation active tiles (one bit per tile, one uint16_t per raw row)
+void find_blobs(uint8_t zSeedThreshold, image_t* inputFrame_ptr, uint16_t* activeTiles_ptr, tracks_t* tracks_ptr) {
+  uint8_t zThreshold = LOW_THRESHOLD(zSeedThreshold);
+#if BLOB_LABELLER == RUN_LENGTH_UNION_FIND
+  blobs_union_find(zThreshold, inputFrame_ptr, activeTiles_ptr);
+#else
+  blobs_flood_fill(zThreshold, inputFrame_ptr, activeTiles_ptr, tracks_ptr);
+#endif
+  blobs_tracking(tracks_ptr, zSeedThreshold - zThreshold);
+}
+
+#if BLOB_STREAMING
+/////////////////////////////// Streaming interpolate / threshold / label
+// Each output row is interpolated (interp_row), thresholded into row words and its runs are labelled
+// against the previous row runs only, no full frame buffer is used
+// Labels are merged with union-find and carry the blobs statistics (merged into the root label)
+static uint8_t label_find(uint8_t index) {
+  while (labelArray[index].parent != index) {
+    labelArray[index].parent = labelArray[labelArray[index].parent].parent; // Path halving
+    index = labelArray[index].parent;
+  };
+  return index;
+};
+
+static void label_union(uint8_t labelA, uint8_t labelB) {
+  uint8_t rootA = label_find(labelA);
+  uint8_t rootB = label_find(labelB);
+  if (rootA == rootB) return;
+  label_merge(&labelArray[MIN(rootA, rootB)], &labelArray[MAX(rootA, rootB)]);
+  labelArray[MAX(rootA, rootB)].parent = MIN(rootA, rootB);
+};
+
+// outputFrame_ptr : the interpolated frame, only its size is used
+void find_blobs_streaming(uint8_t zSeedThreshold, image_t* inputFrame_ptr, image_t* outputFrame_ptr, tracks_t* tracks_ptr) {
+
+  uint8_t zThreshold = LOW_THRESHOLD(zSeedThreshold);
+  uint8_t numCols = outputFrame_ptr->numCols;
+  uint8_t scale = numCols / RAW_COLS;
+  uint16_t minBlobPix = MIN_BLOB_PIX * scale * scale / (SCALE_X * SCALE_Y);
+  float posScale = SCALE_X / (float)scale;
+
+  interp_active_tiles(inputFrame_ptr);
+
+  run_t* prevRuns_ptr = &streamRunArray[0][0];
+  run_t* runs_ptr = &streamRunArray[1][0];
+  uint8_t prevRuns = 0;
+  uint8_t labels = 0;
+
+  for (uint8_t posY = 0; posY < (RAW_ROWS - 1) * scale; posY++) { // The last raw row have no tiles
+    uint8_t runs = 0;
+
+    if (interpActiveTiles[posY / scale]) {
+      interp_row(inputFrame_ptr, posY, &streamRowArray[0]);
+      threshold_row(&streamRowArray[0], numCols, zThreshold, &streamWordsArray[0]);
+
+      uint8_t prev = 0;
+      uint8_t posX = bitmap_scan(&streamWordsArray[0], 0, numCols, 0);
+
+      while (posX < numCols && runs < MAX_ROW_RUNS) {
+        run_t* run_ptr = &runs_ptr[runs++];
+        run_ptr->y = posY;
+        run_ptr->x1 = posX;
+        posX = bitmap_scan(&streamWordsArray[0], posX, numCols, 0xFFFFFFFF); // Run end
+        run_ptr->x2 = posX - 1;
+        run_moments(run_ptr, &streamRowArray[0], zThreshold);
+
+        // Take the label of the overlapping runs of the previous row (4-connectivity) and merge them
+        run_ptr->label = NO_LABEL;
+        while (prev < prevRuns && prevRuns_ptr[prev].x2 < run_ptr->x1) prev++;
+        for (uint8_t i = prev; i < prevRuns && prevRuns_ptr[i].x1 <= run_ptr->x2; i++) {
+          if (prevRuns_ptr[i].label == NO_LABEL) continue;
+          if (run_ptr->label == NO_LABEL) run_ptr->label = prevRuns_ptr[i].label;
+          else label_union(run_ptr->label, prevRuns_ptr[i].label);
+        };
+        if (run_ptr->label == NO_LABEL && labels < MAX_LABELS) {
+          label_init(&labelArray[labels]);
+          labelArray[labels].parent = labels;
+          run_ptr->label = labels++;
+        };
+        if (run_ptr->label != NO_LABEL) {
+          label_add_run(&labelArray[label_find(run_ptr->label)], run_ptr);
+        };
+        if (posX < numCols) posX = bitmap_scan(&streamWordsArray[0], posX, numCols, 0); // Next run start
+      };
+    };
+
+    run_t* swap_ptr = prevRuns_ptr;
+    prevRuns_ptr = runs_ptr;
+    runs_ptr = swap_ptr;
+    prevRuns = runs;
+  };
+
+  for (uint8_t i = 0; i < labels; i++) {
+    if (labelArray[i].parent == i && labelArray[i].pixels > minBlobPix) {
+      label_to_blob(&labelArray[i], zThreshold, posScale);
+    };
+  };
+
+  blobs_tracking(tracks_ptr, zSeedThreshold - zThreshold);
+};
+#endif
+
+#if DEBUG_BLOB_BENCH
+#define BENCH_LOOPS         20   // Number of labelling runs per timing
+
+// Draw touches gaussian touches at pseudo random positions into the frame (interpolated scale)
+static void blob_bench_frame(image_t* frame_ptr, uint8_t touches) {
+  uint8_t numCols = frame_ptr->numCols;
+  uint8_t numRows = frame_ptr->numRows;
+  float sigma = 1.2f * numCols / RAW_COLS;
+  uint32_t seed = 12345;
+  memset(frame_ptr->pData, 0, numCols * numRows);
+  for (uint8_t i = 0; i < touches; i++) {
+    seed = seed * 1103515245 + 12345;
+    float cx = ((seed >> 16) % 1000) / 1000.0f * numCols;
+    seed = seed * 1103515245 + 12345;
+    float cy = ((seed >> 16) % 1000) / 1000.0f * numRows;
+    for (uint8_t posY = 0; posY < numRows; posY++) {
+      uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(frame_ptr, posY);
+      for (uint8_t posX = 0; posX < numCols; posX++) {
+        float dist = pow(posX - cx, 2) + pow(posY - cy, 2);
+        row_ptr[posX] = MIN(255, row_ptr[posX] + (int)(120 * expf(-dist / (2 * sigma * sigma))));
+      };
+    };
+  };
+};
+
+// Compare the flood fill and union-find labellers on dense multi-touch frames
+void blob_bench(image_t* frame_ptr) {
+  uint16_t activeTiles[RAW_ROWS];
+  for (uint8_t rowPos = 0; rowPos < RAW_ROWS; rowPos++) {
+    activeTiles[rowPos] = 0xFFFF;
+  };
+  for (uint8_t touches = 1; touches <= 16; touches *= 2) {
+    blob_bench_frame(frame_ptr, touches);
+    for (uint8_t labeller = 0; labeller < 2; labeller++) {
+      uint8_t blobs = 0;
+      uint32_t start = micros();
+      for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+        if (labeller) blobs_union_find(10, frame_ptr, &activeTiles[0]);
+        else blobs_flood_fill(10, frame_ptr, &activeTiles[0], NULL);
+        blobs = 0;
+        for (lnode_t* node_ptr = ITERATOR_START_FROM_HEAD(&llist_blobs); node_ptr != NULL; node_ptr = ITERATOR_NEXT(node_ptr)) {
+          blobs++;
+        };
+        llist_save_nodes(&llist_blobs_stack, &llist_blobs);
+      };
+      uint32_t duration = micros() - start;
+      Serial.printf("\nDEBUG_BLOB_BENCH / %s / Touches: %d / Blobs: %d / Time: %dus",
+                    labeller ? "UNION_FIND" : "FLOOD_FILL", touches, blobs, duration / BENCH_LOOPS);
+    };
+  };
+};
+#endif
+
+#if RAW_BLOBS
+/////////////////////////////// Raw frame connected-component labeling
+// 4-connected flood fill on the raw cells above the zThreshold
+// Centroid & size are given by the (pixel - zThreshold) weighted moments, in the SCALE_X scale
+void find_raw_blobs(uint8_t zSeedThreshold, image_t* inputFrame_ptr, tracks_t* tracks_ptr) {
+
+  uint8_t zThreshold = LOW_THRESHOLD(zSeedThreshold);
+
+  memset((uint16_t*)rawBitmap, 0, sizeof(rawBitmap));
+
+  for (uint8_t posY = 0; posY < RAW_ROWS; posY++) {
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY);
+    for (uint8_t posX = 0; posX < RAW_COLS; posX++) {
+      if (((rawBitmap[posY] >> posX) & 1) || !PIXEL_THRESHOLD(IMAGE_GET_PIXEL_FAST(row_ptr, posX), zThreshold)) continue;
+
+      uint16_t lifoSize = 0;
+      rawLifoArray[lifoSize++] = posY * RAW_COLS + posX;
+      rawBitmap[posY] |= 1 << posX;
+
+      label_t blob_label;
+      label_init(&blob_label);
+
+      while (lifoSize > 0) {
+        uint8_t index = rawLifoArray[--lifoSize];
+        uint8_t x = index % RAW_COLS;
+        uint8_t y = index / RAW_COLS;
+
+        run_t run; // One cell run
+        run.y = y;
+        run.x1 = x;
+        run.x2 = x;
+        run_moments(&run, COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, y), zThreshold);
+        label_add_run(&blob_label, &run);
+
+        // Push the unvisited neighbours above the zThreshold
+        if (x > 0 && !((rawBitmap[y] >> (x - 1)) & 1) && PIXEL_THRESHOLD(inputFrame_ptr->pData[index - 1], zThreshold)) {
+          rawBitmap[y] |= 1 << (x - 1);
+          rawLifoArray[lifoSize++] = index - 1;
+        };
+        if (x < RAW_COLS - 1 && !((rawBitmap[y] >> (x + 1)) & 1) && PIXEL_THRESHOLD(inputFrame_ptr->pData[index + 1], zThreshold)) {
+          rawBitmap[y] |= 1 << (x + 1);
+          rawLifoArray[lifoSize++] = index + 1;
+        };
+        if (y > 0 && !((rawBitmap[y - 1] >> x) & 1) && PIXEL_THRESHOLD(inputFrame_ptr->pData[index - RAW_COLS], zThreshold)) {
+          rawBitmap[y - 1] |= 1 << x;
+          rawLifoArray[lifoSize++] = index - RAW_COLS;
+        };
+        if (y < RAW_ROWS - 1 && !((rawBitmap[y + 1] >> x) & 1) && PIXEL_THRESHOLD(inputFrame_ptr->pData[index + RAW_COLS], zThreshold)) {
+          rawBitmap[y + 1] |= 1 << x;
+          rawLifoArray[lifoSize++] = index + RAW_COLS;
+        };
+      };
+
+      if (blob_label.pixels * SCALE_X * SCALE_Y > MIN_BLOB_PIX) {
+        blob_t* blob = label_to_blob(&blob_label, zThreshold, SCALE_X);
+        if (blob == NULL) continue;
+        // The raw cells box is too coarse: W & H are the +/- 2 sigma extent of the blob
+        float cx = blob_label.mx / (float)blob_label.m;
+        float cy = blob_label.my / (float)blob_label.m;
+        blob->box.W = 4 * sqrtf(MAX(blob_label.mxx / (float)blob_label.m - cx * cx, 0.0f)) * SCALE_X;
+        blob->box.H = 4 * sqrtf(MAX(blob_label.myy / (float)blob_label.m - cy * cy, 0.0f)) * SCALE_Y;
+      };
+    };
+  };
+
+  blobs_tracking(tracks_ptr, zSeedThreshold - zThreshold);
+};
+#endif
+
+// Velocity & pressure rate given by the alpha-beta filter (pixels & pressure units per second)
+void getBlobsVelocity(tracks_t* tracks_ptr) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    float vx = tracks_ptr->velX[id];
+    float vy = tracks_ptr->velY[id];
+    tracks_ptr->speed[id] = sqrt(vx * vx + vy * vy); //pow(vx, 2) + pow(vy, 2)
+#if DEBUG_MAPPING
+    Serial.printf("\nDEBUG_VELOCITY:\tvxy:%f\tvz:%f", tracks_ptr->speed[id], tracks_ptr->depthRate[id]);
+#endif
+  };
+};
 
-void getPolarCoordinates(llist_t* blobs_ptr) {
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(blobs_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-    float posX = blob_ptr->centroid.X - CENTER_X;
-    float posY = blob_ptr->centroid.Y - CENTER_Y;
+void getPolarCoordinates(tracks_t* tracks_ptr) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    float posX = tracks_ptr->X[id] - CENTER_X;
+    float posY = tracks_ptr->Y[id] - CENTER_Y;
     if (posX == 0 && posY == 0 ) {
-      polarCoord[blob_ptr->UID].r = 0;
-      polarCoord[blob_ptr->UID].phi = 0;
+      tracks_ptr->r[id] = 0;
+      tracks_ptr->phi[id] = 0;
     }
     else {
-      polarCoord[blob_ptr->UID].r = sqrt(posX * posX + posY * posY);
+      tracks_ptr->r[id] = sqrt(posX * posX + posY * posY);
       if (posX == 0 && 0 < posY) {
-        polarCoord[blob_ptr->UID].phi = PI / 2;
+        tracks_ptr->phi[id] = PI / 2;
       } else if (posX == 0 && posY < 0) {
-        polarCoord[blob_ptr->UID].phi = PI * 3 / 2;
+        tracks_ptr->phi[id] = PI * 3 / 2;
       } else if (posX < 0) {
-        polarCoord[blob_ptr->UID].phi = atan(posY / posX) + PI;
+        tracks_ptr->phi[id] = atan(posY / posX) + PI;
       } else if (posY < 0) {
-        polarCoord[blob_ptr->UID].phi = atan(posY / posX) + 2 * PI;
+        tracks_ptr->phi[id] = atan(posY / posX) + 2 * PI;
       } else {
-        polarCoord[blob_ptr->UID].phi = atan(posY / posX);
+        tracks_ptr->phi[id] = atan(posY / posX);
       }
     }
 #if DEBUG_MAPPING
-    Serial.printf("\nDEBUG_POLAR:\tR:%f\tPHY:%f", polarCoord[blob_ptr->UID].r, polarCoord[blob_ptr->UID].phi);
+    Serial.printf("\nDEBUG_POLAR:\tR:%f\tPHY:%f", tracks_ptr->r[id], tracks_ptr->phi[id]);
 #endif
   }
 }
@@ -30,7 +30,13 @@ typedef struct llist llist_t;          // Forward declaration
 #define UINT8_T_MASK    (UINT8_T_BITS - 1)
 #define UINT8_T_SHIFT   IM_LOG2(UINT8_T_MASK)
 
+#define UINT32_T_BITS   (sizeof(uint32_t) * 8)
+#define UINT32_T_MASK   (UINT32_T_BITS - 1)
+#define UINT32_T_SHIFT  IM_LOG2(UINT32_T_MASK)
+
 #define SIZEOF_FRAME    (NEW_FRAME * sizeof(uint8_t))
+#define SIZEOF_BITMAP(cols, rows) ((((cols) + UINT8_T_MASK) >> UINT8_T_SHIFT) * (rows))
+#define WORDS_PER_ROW(cols) (((cols) + UINT32_T_MASK) >> UINT32_T_SHIFT)
 
 #define COMPUTE_IMAGE_ROW_PTR(pImage, y) \
   ({ \
@@ -39,11 +45,11 @@ typedef struct llist llist_t;          // Forward declaration
     ((uint8_t*)_pImage->pData) + (_pImage->numCols * _y); \
   })
 
-#define COMPUTE_BINARY_IMAGE_ROW_PTR(bitmap, y) \
+#define COMPUTE_BINARY_IMAGE_ROW_PTR(pBitmap, y) \
   ({ \
-    __typeof__ (bitmap) _bitmap = (bitmap); \
+    __typeof__ (pBitmap) _pBitmap = (pBitmap); \
     __typeof__ (y) _y = (y); \
-    ((uint8_t*)_bitmap) + (((NEW_COLS + UINT8_T_MASK) >> UINT8_T_SHIFT) * _y); \
+    ((uint8_t*)_pBitmap->pData) + (((_pBitmap->numCols + UINT8_T_MASK) >> UINT8_T_SHIFT) * _y); \
   })
 
 #define IMAGE_GET_PIXEL_FAST(row_ptr, x) \
@@ -106,6 +112,44 @@ struct xylr {
   uint8_t b_l;
 };
 
+// w is the pixel weight (pixel - zThreshold)
+typedef struct run run_t;
+struct run {
+  uint32_t wx;     // Sum of w * x
+  uint32_t wxx;    // Sum of w * x * x
+  uint16_t w;      // Sum of w
+  uint16_t parent;
+  uint8_t y;
+  uint8_t x1;
+  uint8_t x2;
+  uint8_t depth;
+  uint8_t label;
+};
+
+typedef struct label label_t;
+struct label {
+  uint64_t mxx;    // Second order moments
+  uint64_t myy;
+  uint64_t mxy;
+  uint32_t m;      // Pressure mass
+  uint32_t mx;     // First order moments
+  uint32_t my;
+  uint16_t pixels;
+  uint8_t x1;
+  uint8_t x2;
+  uint8_t y1;
+  uint8_t y2;
+  uint8_t depth;
+  uint8_t parent;
+};
+
+typedef struct peak peak_t;
+struct peak {
+  uint8_t x;
+  uint8_t y;
+  uint8_t val;
+};
+
 typedef struct point point_t;
 struct point {
   float X;
@@ -119,47 +163,107 @@ struct box {
   uint8_t D; // TODO Make it as float
 };
 
-typedef enum status {
-  FREE,
-  NOT_FOUND,
-  TO_REMOVE
-} status_t;
+// Equivalent ellipse of the blob pressure distribution
+typedef struct ellipse ellipse_t;
+struct ellipse {
+  float major; // Major axis length (+/- 2 sigma extent)
+  float minor; // Minor axis length (+/- 2 sigma extent)
+  float angle; // Major axis orientation [-PI/2:PI/2] (radians, from the X axis)
+};
 
 typedef struct blob blob_t;
 struct blob {
   lnode_t node;
-  uint8_t UID;
-  status_t status;
   uint32_t timeTag;
   uint16_t pixels;
-  boolean state;
-  boolean lastState;
+  float mass;         // Sum of the (pixel - zThreshold) values
   box_t box;
-  point_t centroid;
+  point_t centroid;   // Pressure weighted centroid
+  ellipse_t ellipse;
 };
 
-void lifo_llist_init(llist_t *list, xylr_t* nodesArray);
-void blob_llist_init(llist_t *list, blob_t* nodesArray);
+#define MAX_BLOBS           32  // [1:64] Set how many blobs can be tracked at the same time
+#define MEDIAN_WINDOW       5   // Allowed median filter window size : 3, 5, 7...
 
-void BLOB_SETUP(llist_t* outputBlobs_ptr);
-void find_blobs(uint8_t zThreshold, image_t* inputFrame_ptr, llist_t* outputBlobs_ptr);
+// Tracks flags
+#define TRACK_STATE         (1 << 0) // The track is pressed
+#define TRACK_LAST_STATE    (1 << 1) // The track was pressed in the last frame
+#define TRACK_NOT_FOUND     (1 << 2) // The track was not found in the current frame
+#define TRACK_TO_REMOVE     (1 << 3) // The track is released, its slot is freed at the next frame
+#define TRACK_MERGED        (1 << 4) // The track is hidden in its parent track blob (BLOB_LINEAGE)
 
-typedef struct velocity velocity_t;
-struct velocity {
-  point_t lastPos;
-  float vxy;
-  float vz;
-  float lvz;
-};
+// Tracks events (BLOB_LINEAGE)
+#define MAX_TRACK_EVENTS    16  // Set how many events a frame can hold
+#define TRACK_EVENT_MERGE   0   // The child track was merged into the parent track blob
+#define TRACK_EVENT_SPLIT   1   // The child track went out of the parent track blob
 
-void getBlobsVelocity(llist_t* blobs_ptr);
+#define TRACK_GET_STATE(tracks_ptr, id)      (((tracks_ptr)->flags[id] & TRACK_STATE) != 0)
+#define TRACK_GET_LAST_STATE(tracks_ptr, id) (((tracks_ptr)->flags[id] & TRACK_LAST_STATE) != 0)
 
-typedef struct polar polar_t;
-struct polar {
-  float r;
-  float phi;
+typedef struct track_event track_event_t;
+struct track_event {
+  uint8_t type;
+  uint8_t parent;
+  uint8_t child;
 };
 
-void getPolarCoordinates(llist_t* blobs_ptr);
+// Structure of arrays, one slot per track, the slot index is the track UID
+// Iterate over the live tracks with the liveMask count trailing zeros (the pending tracks are not given to the outputs)
+typedef struct tracks tracks_t;
+struct tracks {
+  uint64_t liveMask;                        // One bit per live track
+  uint64_t pendingMask;                     // One bit per new track waiting for its birth confirmation (not pressed)
+  uint8_t flags[MAX_BLOBS];                 // TRACK_STATE, TRACK_LAST_STATE...
+  uint16_t age[MAX_BLOBS];                  // Frames since the track birth
+  uint8_t missed[MAX_BLOBS];                // Frames since the last detection
+  uint32_t timeTag[MAX_BLOBS];              // Scan time of the last detection (micros)
+  uint32_t timeStamp[MAX_BLOBS];            // Scan time of the last measure (micros)
+  uint16_t pixels[MAX_BLOBS];
+  float mass[MAX_BLOBS];                    // Pressure mass
+  float X[MAX_BLOBS];                       // Centroid (filtered)
+  float Y[MAX_BLOBS];
+  uint8_t W[MAX_BLOBS];                     // Box
+  uint8_t H[MAX_BLOBS];
+  uint8_t D[MAX_BLOBS];
+  float major[MAX_BLOBS];                   // Equivalent ellipse
+  float minor[MAX_BLOBS];
+  float angle[MAX_BLOBS];
+  float posX[MAX_BLOBS];                    // Alpha-beta filter position
+  float posY[MAX_BLOBS];
+  float velX[MAX_BLOBS];                    // Alpha-beta filter velocity (pixels per second)
+  float velY[MAX_BLOBS];
+  float depth[MAX_BLOBS];                   // Alpha-beta filter depth
+  float depthRate[MAX_BLOBS];               // Alpha-beta filter depth rate (per second)
+  float speed[MAX_BLOBS];                   // XY velocity magnitude (getBlobsVelocity)
+  float r[MAX_BLOBS];                       // Polar coordinates (getPolarCoordinates)
+  float phi[MAX_BLOBS];
+  float zVal[MAX_BLOBS][MEDIAN_WINDOW];     // Median filter values ring storage (median)
+  uint8_t zSort[MAX_BLOBS][MEDIAN_WINDOW];  // Median filter values order
+  uint8_t zIndex[MAX_BLOBS];                // Median filter ring storage current index
+  uint8_t parent[MAX_BLOBS];                // Track that hides the merged track (BLOB_LINEAGE)
+  float offsetX[MAX_BLOBS];                 // Merged track position from its parent track (BLOB_LINEAGE)
+  float offsetY[MAX_BLOBS];
+  track_event_t events[MAX_TRACK_EVENTS];   // Merge & split events of the current frame (BLOB_LINEAGE)
+  uint8_t eventCount;
+};
+
+extern uint32_t frameTime;
+extern uint32_t assignmentTime;
+
+void lifo_llist_init(llist_t *list, xylr_t* nodesArray);
+void blob_llist_init(llist_t *list, blob_t* nodesArray);
+
+void BLOB_SETUP(tracks_t* tracks_ptr);
+void find_blobs(uint8_t zThreshold, image_t* inputFrame_ptr, uint16_t* activeTiles_ptr, tracks_t* tracks_ptr);
+void find_raw_blobs(uint8_t zThreshold, image_t* inputFrame_ptr, tracks_t* tracks_ptr);
+void find_blobs_streaming(uint8_t zThreshold, image_t* inputFrame_ptr, image_t* outputFrame_ptr, tracks_t* tracks_ptr);
+
+#if DEBUG_BLOB_BENCH
+void blob_bench(image_t* frame_ptr);
+#endif
+
+void getBlobsVelocity(tracks_t* tracks_ptr);
+void blobs_predict(tracks_t* tracks_ptr, uint32_t time);
+void getPolarCoordinates(tracks_t* tracks_ptr);
 
 #endif /*__BLOB_H__*/
@@ -10,7 +10,7 @@
 #include <Arduino.h>
 
 #define NAME                "E256"
-#define VERSION             "1.0.5"
+#define VERSION             "1.1.0"
 
 #define USB_MIDI            0  // [0:1] Set the eTextile-Synthesizer as USB MIDI divice **DO NOT FORGET: Arduino/Touls/USB_Type/MIDI**
 #define USB_SLIP_OSC        1  // [0:1] Set the eTextile-Synthesizer as USB SLIP_OSC divice **DO NOT FORGET: Arduino/Touls/USB_Type/Serial**
@@ -23,25 +23,77 @@
 #define DEBUG_BUTTONS       0  // [0:1] Print buttons states
 #define DEBUG_ADC           0  // [0:1] Print 16x16 Analog raw values
 #define DEBUG_INTERP        0  // [0:1] Print 64x64 interpolated values
+#define DEBUG_INTERP_CHECK  0  // [0:1] Print max error between the selected interpolation kernel and the float reference
+#define DEBUG_INTERP_BENCH  0  // [0:1] Print bilinear vs bicubic speed & centroid linearity on synthetic sliding touches (at startup)
 #define DEBUG_BITMAP        0  // [0:1] Print 64x64 binary image based on threshold
 #define DEBUG_FIND_BLOBS    0  // [0:1] Print lowlevel blobs values
 #define DEBUG_BLOBS         0  // [0:1] Print blobs values
+#define DEBUG_BLOB_BENCH    0  // [0:1] Print flood fill vs union-find labelling speed on synthetic multi-touch frames (at startup)
 #define DEBUG_MAPPING       0  // [0:1] Print blobs values
 
 #define BAUD_RATE           230400
 #define RAW_COLS            16
 #define RAW_ROWS            16
 #define RAW_FRAME           (RAW_COLS * RAW_ROWS)
-#define SCALE_X             4
-#define SCALE_Y             4
+#define SCALE_X             4  // [1, 2, 4, 8] Interpolation scale factor at startup (the blobs coordinates are always given in this scale)
+#define SCALE_Y             4  // Must be the same as SCALE_X
 #define NEW_COLS            (RAW_COLS * SCALE_X)
 #define NEW_ROWS            (RAW_ROWS * SCALE_Y)
 #define NEW_FRAME           (NEW_COLS * NEW_ROWS)
+#define MAX_SCALE           8  // [1, 2, 4, 8] Biggest interpolation scale factor that can be selected at runtime (sets the frames arena size)
+#define MAX_NEW_COLS        (RAW_COLS * MAX_SCALE)
+#define MAX_NEW_ROWS        (RAW_ROWS * MAX_SCALE)
+#define MAX_NEW_FRAME       (MAX_NEW_COLS * MAX_NEW_ROWS)
 #define X_MAX               58 // Blobs centroid X max value
 #define Y_MAX               58 // Blobs centroid Y max value
 #define MAX_SYNTH           8  // [1:8] How many synthesizers can be played at the same time
 
+// Frame sources
+#define FRAME_SOURCE_MATRIX 0  // SPI/ADC scan of the textile matrix
+#define FRAME_SOURCE_REPLAY 1  // Recorded frames replayed from a file at full speed (host)
+#define FRAME_SOURCE_SYNTH  2  // Parametric synthetic touches (see synthTouches)
+#define FRAME_SOURCE        FRAME_SOURCE_MATRIX // [FRAME_SOURCE_MATRIX:FRAME_SOURCE_SYNTH] Select the raw frames source
+#define CROSSTALK           0  // [0:1] Subtract the rows & columns leakage (ghosting) from the raw frames (coefficients in crosstalk.cpp)
+#define CALIBRATION_SAVE    1  // [0:1] Save the calibration baseline to the EEPROM while the matrix is not touched & reload it at startup (no startup calibration)
+#define BASELINE_TRACKING   1  // [0:1] Track the cells resting values & noise to set their thresholds (the blobs thresholds are margins above them)
+#define BASELINE_TOUCH_DRIFT 0 // [0:1] BASELINE_TRACKING touched cells resting values drift slowly to their value (objects left on the matrix fade out, held presses too) or are frozen
+#define CELL_GAIN           0  // [0:1] Per cell gain & pressure curve lookup tables applied by the scan (gains set with the /g OSC command)
+#define PRESSURE_CURVE      1.0 // [0.2:5.0] CELL_GAIN pressure curve exponent (1.0 is linear, above 1.0 expands the high pressures)
+
+// Interpolation kernels
+#define BILINEAR_FLOAT      0  // Float reference kernel
+#define BILINEAR_FIXED      1  // Q8 integer kernel (no FPU needed, bit exact with the float kernel when SCALE_X * SCALE_Y is a power of two)
+#define BILINEAR_SEPARABLE  2  // Q8 integer kernel, horizontal then vertical pass with running adds (same output as BILINEAR_FIXED)
+#define BILINEAR_SIMD       3  // Q8 integer kernel, four output pixels per 32-bit word using the Cortex-M DSP SMLAD instruction (scale 1 & 2 use BILINEAR_FIXED)
+#define BICUBIC_CATMULL_ROM 4  // Q8 integer separable Catmull-Rom kernel (smoother pressure surface)
+#define INTERP_KERNEL       BILINEAR_FIXED // [BILINEAR_FLOAT:BICUBIC_CATMULL_ROM] Select the interpolation kernel
+#define INTERP_DIRTY_TILES  1  // [0:1] Only re-interpolate the tiles whose raw corners changed since the last frame
+#define INTERP_NOISE_TOLERANCE 1 // [0:255] Raw value change that is ignored by INTERP_DIRTY_TILES
+#define INTERP_HYSTERESIS   2  // [0:255] An active tile stay active until all its corners fall below interpThreshold minus this value
+
+// Blob labellers
+#define SCANLINE_FLOOD_FILL   0  // Scanline flood fill seeded from the tracks then swept over the active tiles (bounded by LIFO_NODES)
+#define RUN_LENGTH_UNION_FIND 1  // Row runs merged with union-find in two passes (bounded by MAX_RUNS)
+#define BLOB_LABELLER       RUN_LENGTH_UNION_FIND // [SCANLINE_FLOOD_FILL:RUN_LENGTH_UNION_FIND] Select the blob labeller
+
+#define BLOB_SPLIT          0  // [0:1] Split the merged touches at their pressure peaks (RUN_LENGTH_UNION_FIND only)
+#define BLOB_SPLIT_PROMINENCE 8 // [1:255] Minimum pressure drop between two peaks to split their blob
+#define BLOB_LINEAGE        1  // [0:1] Keep the merged touches IDs hidden in their parent track & send the merge/split events
+#define BLOB_HYSTERESIS     3  // [0:255] A new blob must reach the threshold, a found blob is grown & kept down to the threshold minus this value
+#define BLOB_BIRTH_FRAMES   2  // [1:255] Frames a new blob must be found in a row before its track is pressed
+#define BLOB_DEATH_FRAMES   2  // [1:255] Frames without blob before a track is released (with BLOB_DEATH_TIME)
+#define BLOB_DEATH_TIME     20000 // [0:1000000] Time (us) without blob before a track is released (with BLOB_DEATH_FRAMES)
+#define BLOB_ASSIGNMENT_MAX 16 // [1:MAX_BLOBS] Largest blobs or tracks count matched with the optimal assignment (O(n^3)), above it the greedy nearest match (O(n^2)) keeps the tracking within its frame time budget
+#define BLOB_PREDICTION     0  // [0:1] Predict the blobs positions forward to the transmission time (hide the scan to output latency, the sent positions are extrapolated)
+#define BLOB_STREAMING      0  // [0:1] Fused interpolate, threshold & label pass, one output row at a time (interpFrameArray is only computed on /i requests)
+#define RAW_BLOBS           0  // [0:1] Find the blobs directly on the raw frame (pressure weighted moments, no interpolation)
+#define RAW_BLOBS_PATCH     0  // [0:1] With RAW_BLOBS, interpolate only the tiles around each blob
+
 #define PI                  3.1415926535897932384626433832795
 #define PI2                 (PI+PI)
 
+#if defined(E256_HOST)
+#include "host_config.h"            // Linux host build overrides (see Firmware/host)
+#endif
+
 #endif /*__CONFIG_H__*/
@@ -0,0 +1,48 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+#include "crosstalk.h"
+
+#if CROSSTALK
+
+// Leakage coefficients (Q16), fit them on frames recorded with your matrix (Software/crosstalk_fit)
+#ifndef CROSSTALK_ROW_COEF
+#define CROSSTALK_ROW_COEF  1311           // Ghost pressure per unit of pressure on the same row
+#endif
+#ifndef CROSSTALK_COL_COEF
+#define CROSSTALK_COL_COEF  1311           // Ghost pressure per unit of pressure on the same column
+#endif
+
+// Passive matrix ghosting compensation
+// Each cell gets a ghost pressure proportional to the pressure on the other cells of its row & column:
+// ghost = (CROSSTALK_ROW_COEF * (rowSum - val) + CROSSTALK_COL_COEF * (colSum - val)) >> 16
+void crosstalk(image_t* inputFrame_ptr) {
+
+  uint16_t rowSum[RAW_ROWS];
+  uint16_t colSum[RAW_COLS] = {0};
+
+  for (uint8_t posY = 0; posY < RAW_ROWS; posY++) {
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY);
+    uint16_t sum = 0;
+    for (uint8_t posX = 0; posX < RAW_COLS; posX++) {
+      uint8_t val = IMAGE_GET_PIXEL_FAST(row_ptr, posX);
+      sum += val;
+      colSum[posX] += val;
+    };
+    rowSum[posY] = sum;
+  };
+
+  for (uint8_t posY = 0; posY < RAW_ROWS; posY++) {
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY);
+    uint32_t rowGhost = CROSSTALK_ROW_COEF * rowSum[posY];
+    for (uint8_t posX = 0; posX < RAW_COLS; posX++) {
+      uint8_t val = IMAGE_GET_PIXEL_FAST(row_ptr, posX);
+      uint32_t ghost = (rowGhost + CROSSTALK_COL_COEF * colSum[posX] - (CROSSTALK_ROW_COEF + CROSSTALK_COL_COEF) * val) >> 16;
+      row_ptr[posX] = val > ghost ? val - ghost : 0;
+    };
+  };
+};
+#endif
@@ -0,0 +1,17 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+#ifndef __CROSSTALK_H__
+#define __CROSSTALK_H__
+
+#include "config.h"
+#include "blob.h"
+
+typedef struct image image_t;       // Forward declaration
+
+void crosstalk(image_t* inputFrame_ptr);
+
+#endif /*__CROSSTALK_H__*/
@@ -6,15 +6,86 @@
 
 #include "interp.h"
 
-uint8_t interpFrameArray[NEW_FRAME] = {0};  // 1D Array to store E256 bilinear interpolated values
+uint8_t interpFrameArray[MAX_NEW_FRAME] __attribute__((aligned(4))) = {0};  // Static arena to store E256 bilinear interpolated values (sized for MAX_SCALE)
 interp_t interp;                            // Interpolation parameters structure
 
-float coef_A[SCALE_X * SCALE_Y] = {0};
-float coef_B[SCALE_X * SCALE_Y] = {0};
-float coef_C[SCALE_X * SCALE_Y] = {0};
-float coef_D[SCALE_X * SCALE_Y] = {0};
+float coef_A[MAX_SCALE * MAX_SCALE] = {0};
+float coef_B[MAX_SCALE * MAX_SCALE] = {0};
+float coef_C[MAX_SCALE * MAX_SCALE] = {0};
+float coef_D[MAX_SCALE * MAX_SCALE] = {0};
 
 uint8_t interpThreshold = 5;
+uint16_t interpActiveTiles[RAW_ROWS] = {0};  // Active tiles of the current frame, shared with find_blobs()
+
+#if INTERP_KERNEL == BILINEAR_SEPARABLE
+uint16_t hInterpArray[RAW_ROWS * MAX_NEW_COLS] = {0};   // 1D Array to store the horizontal pass values (64x16) scaled by the scale factor
+#endif
+
+#if (INTERP_KERNEL == BICUBIC_CATMULL_ROM) || DEBUG_INTERP_BENCH
+#define INTERP_BICUBIC      1
+int16_t cubicCoef[MAX_SCALE * 4] = {0};                 // Catmull-Rom weights (Q8) for each phase [w(-1), w(0), w(1), w(2)]
+int16_t cubicArray[RAW_ROWS * MAX_NEW_COLS] = {0};      // 1D Array to store the horizontal pass values (Q4)
+#endif
+
+#if DEBUG_INTERP_CHECK && (INTERP_KERNEL != BICUBIC_CATMULL_ROM)
+uint8_t interpCheckArray[MAX_NEW_FRAME] = {0};  // 1D Array to store the float reference kernel output
+#endif
+
+#if INTERP_DIRTY_TILES
+uint8_t interpRefArray[RAW_FRAME] = {0};    // 1D Array to store the raw values that produced the current interpFrameArray
+image_t interpRefFrame = {&interpRefArray[0], RAW_COLS, RAW_ROWS};
+uint8_t interpNoiseTolerance = INTERP_NOISE_TOLERANCE;
+uint8_t lastInterpThreshold = 0;
+boolean interpRefreshAll = true;            // Force a full refresh of the interpolated frame
+uint8_t interpDirtyTiles = 0;               // Number of tiles re-interpolated during the last frame
+#endif
+
+/*
+    Bilinear interpolation / Q8 fixed point coefficients
+    The four coefficient tables are computed by the compiler (constexpr) for each supported scale factor
+    The rounding residual is given to the biggest coefficient so the four coefficients always sum to INTERP_Q_ONE
+*/
+template <uint8_t S>
+struct coefQ {
+  uint16_t  A[S * S];
+  uint16_t  B[S * S];
+  uint16_t  C[S * S];
+  uint16_t  D[S * S];
+};
+
+template <uint8_t S>
+static constexpr coefQ<S> make_coefQ(void) {
+  coefQ<S> coef = {};
+  for (uint8_t row = 0; row < S; row++) {
+    for (uint8_t col = 0; col < S; col++) {
+      uint8_t index = row * S + col;
+      uint32_t w[4] = {
+        (uint32_t)(S - col) * (S - row),
+        (uint32_t)col * (S - row),
+        (uint32_t)(S - col) * row,
+        (uint32_t)col * row
+      };
+      int32_t q[4] = {0};
+      int32_t sum = 0;
+      uint8_t maxIndex = 0;
+      for (uint8_t i = 0; i < 4; i++) {
+        q[i] = (w[i] * INTERP_Q_ONE + (S * S) / 2) / (S * S);
+        sum += q[i];
+        if (w[i] > w[maxIndex]) maxIndex = i;
+      };
+      q[maxIndex] += INTERP_Q_ONE - sum;
+      coef.A[index] = q[0];
+      coef.B[index] = q[1];
+      coef.C[index] = q[2];
+      coef.D[index] = q[3];
+    };
+  };
+  return coef;
+};
+
+static constexpr uint8_t log2_scale(uint32_t x) {
+  return (x > 1) ? 1 + log2_scale(x >> 1) : 0;
+};
 
 /*
     Bilinear interpolation
@@ -23,52 +94,94 @@ uint8_t interpThreshold = 5;
 
 void INTERP_SETUP(image_t* outputFrame_ptr) {
 
-  // image_t* outputFrame_ptr init config
-  outputFrame_ptr->pData = &interpFrameArray[0];  // Setup -> uint8_t bilinInterpOutput[NEW_FRAME] (64x64)
-  outputFrame_ptr->numCols = NEW_COLS;
-  outputFrame_ptr->numRows = NEW_ROWS;
-
   // interp_t* interp init config
-  interp.outputStrideY = SCALE_X * SCALE_Y * RAW_COLS;
   interp.pCoefA = &coef_A[0];
   interp.pCoefB = &coef_B[0];
   interp.pCoefC = &coef_C[0];
   interp.pCoefD = &coef_D[0];
 
-  float sFactor = SCALE_X * SCALE_Y;
+  interp_set_scale(SCALE_X, outputFrame_ptr);
+};
+
+// Select the interpolation scale factor [1, 2, 4, 8]
+// The output frame is resized inside the interpFrameArray static arena
+// The active tiles & the dirty tiles reference are cleared
+// The tracks are kept : the blobs coordinates, sizes & filters are given in the SCALE_X scale whatever the scale factor
+boolean interp_set_scale(uint8_t scale, image_t* outputFrame_ptr) {
+
+  if (scale == 0 || scale > MAX_SCALE || (scale & (scale - 1))) {
+    return false;
+  };
+
+  interp.scaleX = scale;
+  interp.scaleY = scale;
+  interp.outputCols = RAW_COLS * scale;
+  interp.outputRows = RAW_ROWS * scale;
+  interp.outputStrideY = scale * scale * RAW_COLS;
+
+  // image_t* outputFrame_ptr init config
+  outputFrame_ptr->pData = &interpFrameArray[0];
+  outputFrame_ptr->numCols = interp.outputCols;
+  outputFrame_ptr->numRows = interp.outputRows;
+
+  float sFactor = scale * scale;
 
-  for (uint8_t row = 0; row < SCALE_Y; row++) {
-    for (uint8_t col = 0; col < SCALE_X; col++) {
-      int index = row * SCALE_Y + col;
-      interp.pCoefA[index] = (SCALE_X - col) * (SCALE_Y - row) / sFactor;
-      interp.pCoefB[index] = col * (SCALE_Y - row) / sFactor;
-      interp.pCoefC[index] = (SCALE_X - col) * row / sFactor;
+  for (uint8_t row = 0; row < scale; row++) {
+    for (uint8_t col = 0; col < scale; col++) {
+      int index = row * scale + col;
+      interp.pCoefA[index] = (scale - col) * (scale - row) / sFactor;
+      interp.pCoefB[index] = col * (scale - row) / sFactor;
+      interp.pCoefC[index] = (scale - col) * row / sFactor;
       interp.pCoefD[index] = row * col / sFactor;
     };
   };
-};
 
-// Bilinear interpolation
-void interp_matrix(image_t* inputFrame_ptr) {
+#if INTERP_BICUBIC
+  // Catmull-Rom weights for each phase t = col / scale
+  for (uint8_t col = 0; col < scale; col++) {
+    float t = col / (float)scale;
+    float w[4] = {
+      (-t * t * t + 2 * t * t - t) / 2,
+      (3 * t * t * t - 5 * t * t + 2) / 2,
+      (-3 * t * t * t + 4 * t * t + t) / 2,
+      (t * t * t - t * t) / 2
+    };
+    int16_t sum = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+      cubicCoef[col * 4 + i] = (int16_t)round(w[i] * INTERP_Q_ONE);
+      sum += cubicCoef[col * 4 + i];
+    };
+    cubicCoef[col * 4 + (t < 0.5 ? 1 : 2)] += INTERP_Q_ONE - sum; // The four weights must sum to INTERP_Q_ONE
+  };
+#endif
 
-  // Clear interpFrameArray
-  memset((uint8_t*)interpFrameArray, 0, SIZEOF_FRAME);
+  memset((uint8_t*)interpFrameArray, 0, MAX_NEW_FRAME);
+  memset((uint16_t*)interpActiveTiles, 0, sizeof(interpActiveTiles));
+#if INTERP_DIRTY_TILES
+  memset((uint8_t*)interpRefArray, 0, RAW_FRAME);
+  interpRefreshAll = true;
+#endif
+  return true;
+};
+
+// Bilinear interpolation (float reference kernel)
+#if (INTERP_KERNEL == BILINEAR_FLOAT) || (DEBUG_INTERP_CHECK && (INTERP_KERNEL != BICUBIC_CATMULL_ROM))
+static void interp_bilinear_float(image_t* inputFrame_ptr, uint16_t* tileMask_ptr, uint8_t* outputFrame_ptr) {
 
   for (uint8_t rowPos = 0; rowPos < (RAW_ROWS - 1); rowPos++) {
-    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, rowPos);
     for (uint8_t colPos = 0; colPos < (RAW_COLS - 1); colPos++) {
-      if (IMAGE_GET_PIXEL_FAST(row_ptr, colPos) > interpThreshold) { // 'Windowing' interpolation
+      if ((tileMask_ptr[rowPos] >> colPos) & 1) { // 'Windowing' interpolation
 
         uint8_t inIndexA = rowPos * RAW_COLS + colPos;
         uint8_t inIndexB = inIndexA + 1;
         uint8_t inIndexC = inIndexA + RAW_COLS;
         uint8_t inIndexD = inIndexC + 1;
 
-        for (uint8_t row = 0; row < SCALE_Y; row++) {
-          for (uint8_t col = 0; col < SCALE_X; col++) {
-            uint8_t coefIndex = row * SCALE_X + col;
-            uint16_t outIndex = rowPos * interp.outputStrideY + colPos * SCALE_X + row * NEW_COLS + col;
-            interpFrameArray[outIndex] =
+        for (uint8_t row = 0; row < interp.scaleY; row++) {
+          for (uint8_t col = 0; col < interp.scaleX; col++) {
+            uint8_t coefIndex = row * interp.scaleX + col;
+            uint16_t outIndex = rowPos * interp.outputStrideY + colPos * interp.scaleX + row * interp.outputCols + col;
+            outputFrame_ptr[outIndex] =
               (uint8_t)round(
                 inputFrame_ptr->pData[inIndexA] * interp.pCoefA[coefIndex] +
                 inputFrame_ptr->pData[inIndexB] * interp.pCoefB[coefIndex] +
@@ -80,11 +193,404 @@ void interp_matrix(image_t* inputFrame_ptr) {
       };
     };
   };
+};
+#endif
+
+// Bilinear interpolation (Q8 integer kernel)
+// Output = (A * coefA + B * coefB + C * coefC + D * coefD + 0.5) >> 8
+template <uint8_t S>
+static void interp_bilinear_fixed(image_t* inputFrame_ptr, uint16_t* tileMask_ptr, uint8_t* outputFrame_ptr) {
+
+  static constexpr coefQ<S> coef = make_coefQ<S>();
+
+  for (uint8_t rowPos = 0; rowPos < (RAW_ROWS - 1); rowPos++) {
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, rowPos);
+    for (uint8_t colPos = 0; colPos < (RAW_COLS - 1); colPos++) {
+      if ((tileMask_ptr[rowPos] >> colPos) & 1) { // 'Windowing' interpolation
+
+        uint32_t valA = IMAGE_GET_PIXEL_FAST(row_ptr, colPos);
+        uint32_t valB = IMAGE_GET_PIXEL_FAST(row_ptr, colPos + 1);
+        uint32_t valC = IMAGE_GET_PIXEL_FAST(row_ptr + RAW_COLS, colPos);
+        uint32_t valD = IMAGE_GET_PIXEL_FAST(row_ptr + RAW_COLS, colPos + 1);
+
+        uint8_t* out_ptr = &outputFrame_ptr[rowPos * S * S * RAW_COLS + colPos * S];
+
+        for (uint8_t row = 0; row < S; row++) {
+          for (uint8_t col = 0; col < S; col++) {
+            uint8_t coefIndex = row * S + col;
+            out_ptr[col] = (uint8_t)((
+                                       valA * coef.A[coefIndex] +
+                                       valB * coef.B[coefIndex] +
+                                       valC * coef.C[coefIndex] +
+                                       valD * coef.D[coefIndex] +
+                                       INTERP_Q_HALF
+                                     ) >> INTERP_Q_SHIFT);
+          };
+          out_ptr += RAW_COLS * S;
+        };
+      };
+    };
+  };
+};
+
+// Bilinear interpolation (separable integer kernel)
+// First pass interpolate each raw row horizontally into hInterpArray using a running add
+// Second pass interpolate vertically between two hInterpArray rows using a running add
+// The sums are the same as the bilinear ones, so the output is the same as interp_bilinear_fixed()
+#if INTERP_KERNEL == BILINEAR_SEPARABLE
+template <uint8_t S>
+static void interp_bilinear_separable(image_t* inputFrame_ptr, uint16_t* tileMask_ptr, uint8_t* outputFrame_ptr) {
+
+  const uint32_t rCoef = ((1UL << INTERP_R_SHIFT) + (S * S) / 2) / (S * S); // 1 / (S * S) in Q16
+
+  for (uint8_t rowPos = 0; rowPos < RAW_ROWS; rowPos++) {
+    if (!tileMask_ptr[rowPos] && (rowPos == 0 || !tileMask_ptr[rowPos - 1])) continue; // Row not used by any tile
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, rowPos);
+    uint16_t* hRow_ptr = &hInterpArray[rowPos * (RAW_COLS * S)];
+    for (uint8_t colPos = 0; colPos < (RAW_COLS - 1); colPos++) {
+      int16_t val = IMAGE_GET_PIXEL_FAST(row_ptr, colPos) * S;
+      int16_t delta = IMAGE_GET_PIXEL_FAST(row_ptr, colPos + 1) - IMAGE_GET_PIXEL_FAST(row_ptr, colPos);
+      for (uint8_t col = 0; col < S; col++) {
+        hRow_ptr[col] = val;
+        val += delta;
+      };
+      hRow_ptr += S;
+    };
+  };
+
+  for (uint8_t rowPos = 0; rowPos < (RAW_ROWS - 1); rowPos++) {
+    uint16_t* hRowA_ptr = &hInterpArray[rowPos * (RAW_COLS * S)];
+    uint16_t* hRowB_ptr = hRowA_ptr + (RAW_COLS * S);
+    for (uint8_t colPos = 0; colPos < (RAW_COLS - 1); colPos++) {
+      if ((tileMask_ptr[rowPos] >> colPos) & 1) { // 'Windowing' interpolation
+
+        uint8_t* out_ptr = &outputFrame_ptr[rowPos * S * S * RAW_COLS + colPos * S];
+
+        // One running add per output column (the rows running adds over val[S] & delta[S] arrays are miscompiled by GCC 12 -O3)
+        for (uint8_t col = 0; col < S; col++) {
+          uint8_t index = colPos * S + col;
+          int32_t val = hRowA_ptr[index] * S;
+          int32_t delta = hRowB_ptr[index] - hRowA_ptr[index];
+          for (uint8_t row = 0; row < S; row++) {
+            out_ptr[row * RAW_COLS * S + col] = (uint8_t)((val * rCoef + INTERP_R_HALF) >> INTERP_R_SHIFT);
+            val += delta;
+          };
+        };
+      };
+    };
+  };
+};
+#endif
+
+// Bilinear interpolation (SIMD integer kernel)
+// Each four pixels of an output block row are computed as one 32-bit word (S must be a multiple of 4)
+// The horizontal pass use SMLAD to blend the two packed corners values with the packed column weights
+// The vertical pass use running adds on two packed halfwords [p0|p2] & [p1|p3]
+// The sums are the same as the bilinear ones, so the output is the same as interp_bilinear_fixed()
+#if INTERP_KERNEL == BILINEAR_SIMD
+template <uint8_t S>
+static void interp_bilinear_simd(image_t* inputFrame_ptr, uint16_t* tileMask_ptr, uint8_t* outputFrame_ptr) {
+
+  static_assert((S % 4) == 0, "interp_bilinear_simd() needs a scale factor multiple of 4");
+  const uint8_t shift = log2_scale(S * S);
+  const uint32_t half = (1UL << (shift - 1)) * 0x00010001UL; // Rounding value for two packed halfwords
+
+  for (uint8_t rowPos = 0; rowPos < (RAW_ROWS - 1); rowPos++) {
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, rowPos);
+    for (uint8_t colPos = 0; colPos < (RAW_COLS - 1); colPos++) {
+      if ((tileMask_ptr[rowPos] >> colPos) & 1) { // 'Windowing' interpolation
+
+        uint32_t valAB = IMAGE_GET_PIXEL_FAST(row_ptr, colPos) | (IMAGE_GET_PIXEL_FAST(row_ptr, colPos + 1) << 16);
+        uint32_t valCD = IMAGE_GET_PIXEL_FAST(row_ptr + RAW_COLS, colPos) | (IMAGE_GET_PIXEL_FAST(row_ptr + RAW_COLS, colPos + 1) << 16);
+
+        for (uint8_t group = 0; group < S; group += 4) {
+          int32_t top[4];
+          int32_t bot[4];
+          for (uint8_t col = 0; col < 4; col++) {
+            uint32_t hCoefPacked = (S - (group + col)) | ((uint32_t)(group + col) << 16);
+            top[col] = INTERP_SMLAD(valAB, hCoefPacked, 0);
+            bot[col] = INTERP_SMLAD(valCD, hCoefPacked, 0);
+          };
+
+          // Packed as plain integers (low + high * 65536) so a 32-bit add can carry the signed deltas
+          uint32_t val02 = (top[0] + (top[2] << 16)) * S;
+          uint32_t val13 = (top[1] + (top[3] << 16)) * S;
+          uint32_t delta02 = (bot[0] - top[0]) + (bot[2] - top[2]) * 65536;
+          uint32_t delta13 = (bot[1] - top[1]) + (bot[3] - top[3]) * 65536;
+
+          uint8_t* out_ptr = &outputFrame_ptr[rowPos * S * S * RAW_COLS + colPos * S + group];
+
+          for (uint8_t row = 0; row < S; row++) {
+            uint32_t pix02 = ((val02 + half) >> shift) & 0x00FF00FF;
+            uint32_t pix13 = ((val13 + half) >> shift) & 0x00FF00FF;
+            uint32_t pixels = pix02 | (pix13 << 8); // [p0|p1|p2|p3] (little endian)
+            memcpy(out_ptr, &pixels, sizeof(uint32_t));
+            val02 += delta02;
+            val13 += delta13;
+            out_ptr += RAW_COLS * S;
+          };
+        };
+      };
+    };
+  };
+};
+#endif
+
+// Bicubic interpolation (separable Catmull-Rom integer kernel)
+// Each output pixel use the 4x4 raw neighbourhood of its tile (clamped on the frame edges)
+// First pass interpolate the raw rows horizontally into cubicArray (Q8 weights, Q4 values)
+// Second pass interpolate vertically from four cubicArray rows (Q8 weights), then clamp to [0:255]
+#if INTERP_BICUBIC
+template <uint8_t S>
+static void interp_bicubic(image_t* inputFrame_ptr, uint16_t* tileMask_ptr, uint8_t* outputFrame_ptr) {
+
+  for (uint8_t rowPos = 0; rowPos < RAW_ROWS; rowPos++) {
+    uint16_t used = tileMask_ptr[rowPos];                      // Rows [rowPos - 2 : rowPos + 1] use this row
+    if (rowPos > 0) used |= tileMask_ptr[rowPos - 1];
+    if (rowPos > 1) used |= tileMask_ptr[rowPos - 2];
+    if (rowPos < RAW_ROWS - 1) used |= tileMask_ptr[rowPos + 1];
+    if (!used) continue;
+
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, rowPos);
+    int16_t* cRow_ptr = &cubicArray[rowPos * RAW_COLS * S];
+    for (uint8_t colPos = 0; colPos < (RAW_COLS - 1); colPos++) {
+      int32_t val0 = IMAGE_GET_PIXEL_FAST(row_ptr, MAX(colPos - 1, 0));
+      int32_t val1 = IMAGE_GET_PIXEL_FAST(row_ptr, colPos);
+      int32_t val2 = IMAGE_GET_PIXEL_FAST(row_ptr, colPos + 1);
+      int32_t val3 = IMAGE_GET_PIXEL_FAST(row_ptr, MIN(colPos + 2, RAW_COLS - 1));
+      for (uint8_t col = 0; col < S; col++) {
+        const int16_t* w = &cubicCoef[col * 4];
+        int32_t sum = val0 * w[0] + val1 * w[1] + val2 * w[2] + val3 * w[3];
+        cRow_ptr[col] = (sum + (1 << (INTERP_Q_SHIFT - INTERP_C_SHIFT - 1))) >> (INTERP_Q_SHIFT - INTERP_C_SHIFT);
+      };
+      cRow_ptr += S;
+    };
+  };
+
+  const uint8_t shift = INTERP_Q_SHIFT + INTERP_C_SHIFT;
+
+  for (uint8_t rowPos = 0; rowPos < (RAW_ROWS - 1); rowPos++) {
+    if (!tileMask_ptr[rowPos]) continue;
+    int16_t* cRow0_ptr = &cubicArray[MAX(rowPos - 1, 0) * RAW_COLS * S];
+    int16_t* cRow1_ptr = &cubicArray[rowPos * RAW_COLS * S];
+    int16_t* cRow2_ptr = &cubicArray[(rowPos + 1) * RAW_COLS * S];
+    int16_t* cRow3_ptr = &cubicArray[MIN(rowPos + 2, RAW_ROWS - 1) * RAW_COLS * S];
+    for (uint8_t colPos = 0; colPos < (RAW_COLS - 1); colPos++) {
+      if ((tileMask_ptr[rowPos] >> colPos) & 1) { // 'Windowing' interpolation
+
+        uint8_t* out_ptr = &outputFrame_ptr[rowPos * S * S * RAW_COLS + colPos * S];
+
+        for (uint8_t row = 0; row < S; row++) {
+          const int16_t* w = &cubicCoef[row * 4];
+          for (uint8_t col = 0; col < S; col++) {
+            uint16_t index = colPos * S + col;
+            int32_t sum =
+              cRow0_ptr[index] * w[0] +
+              cRow1_ptr[index] * w[1] +
+              cRow2_ptr[index] * w[2] +
+              cRow3_ptr[index] * w[3];
+            sum = (sum + (1 << (shift - 1))) >> shift;
+            out_ptr[col] = (uint8_t)constrain(sum, 0, 255);
+          };
+          out_ptr += RAW_COLS * S;
+        };
+      };
+    };
+  };
+};
+#endif
+
+// Run the selected kernel specialised for the current scale factor
+static void interp_kernel(image_t* inputFrame_ptr, uint16_t* tileMask_ptr, uint8_t* outputFrame_ptr) {
+#if INTERP_KERNEL == BILINEAR_FLOAT
+  interp_bilinear_float(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+#else
+  switch (interp.scaleX) {
+#if INTERP_KERNEL == BILINEAR_FIXED || INTERP_KERNEL == BILINEAR_SIMD
+    case 1:
+      interp_bilinear_fixed<1>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+    case 2:
+      interp_bilinear_fixed<2>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+#endif
+#if INTERP_KERNEL == BILINEAR_FIXED
+    case 4:
+      interp_bilinear_fixed<4>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+    case 8:
+      interp_bilinear_fixed<8>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+#elif INTERP_KERNEL == BILINEAR_SEPARABLE
+    case 1:
+      interp_bilinear_separable<1>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+    case 2:
+      interp_bilinear_separable<2>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+    case 4:
+      interp_bilinear_separable<4>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+    case 8:
+      interp_bilinear_separable<8>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+#elif INTERP_KERNEL == BILINEAR_SIMD
+    case 4:
+      interp_bilinear_simd<4>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+    case 8:
+      interp_bilinear_simd<8>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+#elif INTERP_KERNEL == BICUBIC_CATMULL_ROM
+    case 1:
+      interp_bicubic<1>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+    case 2:
+      interp_bicubic<2>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+    case 4:
+      interp_bicubic<4>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+    case 8:
+      interp_bicubic<8>(inputFrame_ptr, tileMask_ptr, outputFrame_ptr);
+      break;
+#endif
+    default:
+      break;
+  };
+#endif
+};
+
+// 'Windowing' : select the active tiles
+// A tile is active if one of its four corners is above the interpThreshold
+// An already active tile (interpActiveTiles) stay active while one of its corners is above interpThreshold - INTERP_HYSTERESIS
+// One bit per tile, one uint16_t per raw row
+static void interp_windowing(image_t* inputFrame_ptr, uint16_t* tileMask_ptr) {
+  uint8_t lowThreshold = MAX(interpThreshold - INTERP_HYSTERESIS, 0);
+  uint16_t lastHigh = 0;
+  uint16_t lastLow = 0;
+  for (uint8_t rowPos = 0; rowPos < RAW_ROWS; rowPos++) {
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, rowPos);
+    uint16_t high = 0;
+    uint16_t low = 0;
+    for (uint8_t colPos = 0; colPos < RAW_COLS; colPos++) {
+      uint8_t val = IMAGE_GET_PIXEL_FAST(row_ptr, colPos);
+      high |= (val > interpThreshold) << colPos;
+      low |= (val > lowThreshold) << colPos;
+    };
+    if (rowPos > 0) {
+      uint16_t tileHigh = lastHigh | high; // Tiles [rowPos - 1] corners
+      uint16_t tileLow = lastLow | low;
+      tileHigh = (tileHigh | (tileHigh >> 1)) & INTERP_TILES_MASK;
+      tileLow = (tileLow | (tileLow >> 1)) & INTERP_TILES_MASK;
+      tileMask_ptr[rowPos - 1] = tileHigh | (interpActiveTiles[rowPos - 1] & tileLow);
+    };
+    lastHigh = high;
+    lastLow = low;
+  };
+  tileMask_ptr[RAW_ROWS - 1] = 0;
+};
+
+#if INTERP_DIRTY_TILES
+// Compare the input frame with the reference frame (the one that produced the current interpFrameArray)
+// A cell is changed if it moved by more than interpNoiseTolerance, the reference frame is then updated
+// A tile is dirty if one of its four corners changed
+static void interp_dirty_tiles(image_t* inputFrame_ptr, uint16_t* dirtyMask_ptr) {
+  uint16_t changed[RAW_ROWS];
+
+  for (uint8_t rowPos = 0; rowPos < RAW_ROWS; rowPos++) {
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, rowPos);
+    uint8_t* ref_row_ptr = COMPUTE_IMAGE_ROW_PTR(&interpRefFrame, rowPos);
+    uint16_t mask = 0;
+    for (uint8_t colPos = 0; colPos < RAW_COLS; colPos++) {
+      uint8_t val = IMAGE_GET_PIXEL_FAST(row_ptr, colPos);
+      if (abs(val - IMAGE_GET_PIXEL_FAST(ref_row_ptr, colPos)) > interpNoiseTolerance) {
+        ref_row_ptr[colPos] = val;
+        mask |= 1 << colPos;
+      };
+    };
+    changed[rowPos] = mask;
+  };
+
+  // Changing the threshold changes the windowing of every tile
+  boolean refreshAll = interpRefreshAll || (interpThreshold != lastInterpThreshold);
+  lastInterpThreshold = interpThreshold;
+  interpRefreshAll = false;
+
+  interpDirtyTiles = 0;
+  for (uint8_t rowPos = 0; rowPos < (RAW_ROWS - 1); rowPos++) {
+    uint16_t mask = changed[rowPos] | changed[rowPos + 1];
+#if INTERP_KERNEL == BICUBIC_CATMULL_ROM
+    // Bicubic tiles use the raw cells [-1:+2] around their top left corner
+    if (rowPos > 0) mask |= changed[rowPos - 1];
+    if (rowPos < RAW_ROWS - 2) mask |= changed[rowPos + 2];
+    mask = mask | (mask << 1) | (mask >> 1);
+#endif
+    mask = refreshAll ? INTERP_TILES_MASK : ((mask | (mask >> 1)) & INTERP_TILES_MASK);
+    dirtyMask_ptr[rowPos] = mask;
+    interpDirtyTiles += __builtin_popcount(mask);
+  };
+  dirtyMask_ptr[RAW_ROWS - 1] = 0;
+};
+#endif
+
+void interp_matrix(image_t* inputFrame_ptr) {
+
+  uint16_t tileMask[RAW_ROWS];
+
+#if INTERP_DIRTY_TILES
+  uint16_t dirtyMask[RAW_ROWS];
+  interp_dirty_tiles(inputFrame_ptr, &dirtyMask[0]);
+  interp_windowing(&interpRefFrame, &tileMask[0]);
+  memcpy(interpActiveTiles, tileMask, sizeof(tileMask));
+
+  // Clear the dirty tiles only
+  for (uint8_t rowPos = 0; rowPos < (RAW_ROWS - 1); rowPos++) {
+    if (dirtyMask[rowPos]) {
+      for (uint8_t colPos = 0; colPos < (RAW_COLS - 1); colPos++) {
+        if ((dirtyMask[rowPos] >> colPos) & 1) {
+          uint8_t* out_ptr = &interpFrameArray[rowPos * interp.outputStrideY + colPos * interp.scaleX];
+          for (uint8_t row = 0; row < interp.scaleY; row++) {
+            memset(out_ptr, 0, interp.scaleX);
+            out_ptr += interp.outputCols;
+          };
+        };
+      };
+      tileMask[rowPos] &= dirtyMask[rowPos];
+    }
+    else {
+      tileMask[rowPos] = 0;
+    };
+  };
+  interp_kernel(&interpRefFrame, &tileMask[0], &interpFrameArray[0]);
+#else
+  // Clear interpFrameArray
+  memset((uint8_t*)interpFrameArray, 0, interp.outputCols * interp.outputRows);
+  interp_windowing(inputFrame_ptr, &tileMask[0]);
+  memcpy(interpActiveTiles, tileMask, sizeof(tileMask));
+  interp_kernel(inputFrame_ptr, &tileMask[0], &interpFrameArray[0]);
+#endif
+
+#if DEBUG_INTERP_CHECK && (INTERP_KERNEL != BICUBIC_CATMULL_ROM)
+#if INTERP_DIRTY_TILES
+  image_t* checkFrame_ptr = &interpRefFrame;
+#else
+  image_t* checkFrame_ptr = inputFrame_ptr;
+#endif
+  memset((uint8_t*)interpCheckArray, 0, interp.outputCols * interp.outputRows);
+  interp_bilinear_float(checkFrame_ptr, &interpActiveTiles[0], &interpCheckArray[0]);
+  uint8_t maxError = 0;
+  for (uint16_t index = 0; index < interp.outputCols * interp.outputRows; index++) {
+    uint8_t error = abs(interpFrameArray[index] - interpCheckArray[index]);
+    if (error > maxError) maxError = error;
+  };
+  Serial.printf("\nDEBUG_INTERP_CHECK / Max error: %d", maxError);
+#endif
 
 #if DEBUG_INTERP
-  for (uint8_t posY = 0; posY < NEW_ROWS; posY++) {
-    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(frame_ptr, posY);
-    for (int posX = 0; posX < NEW_COLS; posX++) {
+  for (uint8_t posY = 0; posY < interp.outputRows; posY++) {
+    uint8_t* row_ptr = &interpFrameArray[posY * interp.outputCols];
+    for (int posX = 0; posX < interp.outputCols; posX++) {
       Serial.printf("%d-", IMAGE_GET_PIXEL_FAST(row_ptr, posX));
     };
     Serial.printf("\n");
@@ -93,3 +599,187 @@ void interp_matrix(image_t* inputFrame_ptr) {
 #endif
 
 };
+
+#if BLOB_STREAMING
+// Bilinear interpolation of a single output row [rowPos * S + row] (fixed point integer kernel)
+// Same output as interp_bilinear_fixed() for the same row
+template <uint8_t S>
+static void interp_bilinear_row(image_t* inputFrame_ptr, uint16_t tiles, uint8_t rowPos, uint8_t row, uint8_t* output_ptr) {
+
+  static constexpr coefQ<S> coef = make_coefQ<S>();
+
+  uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, rowPos);
+  for (uint8_t colPos = 0; colPos < (RAW_COLS - 1); colPos++) {
+    if ((tiles >> colPos) & 1) { // 'Windowing' interpolation
+
+      uint32_t valA = IMAGE_GET_PIXEL_FAST(row_ptr, colPos);
+      uint32_t valB = IMAGE_GET_PIXEL_FAST(row_ptr, colPos + 1);
+      uint32_t valC = IMAGE_GET_PIXEL_FAST(row_ptr + RAW_COLS, colPos);
+      uint32_t valD = IMAGE_GET_PIXEL_FAST(row_ptr + RAW_COLS, colPos + 1);
+
+      uint8_t* out_ptr = &output_ptr[colPos * S];
+
+      for (uint8_t col = 0; col < S; col++) {
+        uint8_t coefIndex = row * S + col;
+        out_ptr[col] = (uint8_t)((
+                                   valA * coef.A[coefIndex] +
+                                   valB * coef.B[coefIndex] +
+                                   valC * coef.C[coefIndex] +
+                                   valD * coef.D[coefIndex] +
+                                   INTERP_Q_HALF
+                                 ) >> INTERP_Q_SHIFT);
+      };
+    };
+  };
+};
+
+// Update interpActiveTiles from the input frame (BLOB_STREAMING mode)
+void interp_active_tiles(image_t* inputFrame_ptr) {
+  uint16_t tileMask[RAW_ROWS];
+  interp_windowing(inputFrame_ptr, &tileMask[0]);
+  memcpy(interpActiveTiles, tileMask, sizeof(tileMask));
+};
+
+// Interpolate the output row posY of the active tiles into output_ptr (interp.outputCols values)
+void interp_row(image_t* inputFrame_ptr, uint8_t posY, uint8_t* output_ptr) {
+  uint8_t rowPos = posY / interp.scaleY;
+  uint8_t row = posY % interp.scaleY;
+  memset(output_ptr, 0, interp.outputCols);
+  if (!interpActiveTiles[rowPos]) return;
+  switch (interp.scaleX) {
+    case 1:
+      interp_bilinear_row<1>(inputFrame_ptr, interpActiveTiles[rowPos], rowPos, row, output_ptr);
+      break;
+    case 2:
+      interp_bilinear_row<2>(inputFrame_ptr, interpActiveTiles[rowPos], rowPos, row, output_ptr);
+      break;
+    case 4:
+      interp_bilinear_row<4>(inputFrame_ptr, interpActiveTiles[rowPos], rowPos, row, output_ptr);
+      break;
+    case 8:
+      interp_bilinear_row<8>(inputFrame_ptr, interpActiveTiles[rowPos], rowPos, row, output_ptr);
+      break;
+    default:
+      break;
+  };
+};
+#endif
+
+#if RAW_BLOBS_PATCH
+// Interpolate only the tiles covered by the raw blobs boxes (RAW_BLOBS mode)
+void interp_blobs(image_t* inputFrame_ptr, tracks_t* tracks_ptr) {
+
+  uint16_t tileMask[RAW_ROWS] = {0};
+
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    int8_t x1 = constrain((int)floorf((tracks_ptr->X[id] - tracks_ptr->W[id] / 2.0f) / SCALE_X), 0, RAW_COLS - 2);
+    int8_t x2 = constrain((int)floorf((tracks_ptr->X[id] + tracks_ptr->W[id] / 2.0f) / SCALE_X), 0, RAW_COLS - 2);
+    int8_t y1 = constrain((int)floorf((tracks_ptr->Y[id] - tracks_ptr->H[id] / 2.0f) / SCALE_Y), 0, RAW_ROWS - 2);
+    int8_t y2 = constrain((int)floorf((tracks_ptr->Y[id] + tracks_ptr->H[id] / 2.0f) / SCALE_Y), 0, RAW_ROWS - 2);
+    uint16_t mask = ((1 << (x2 + 1)) - 1) & ~((1 << x1) - 1);
+    for (int8_t rowPos = y1; rowPos <= y2; rowPos++) {
+      tileMask[rowPos] |= mask;
+    };
+  };
+
+  memset((uint8_t*)interpFrameArray, 0, interp.outputCols * interp.outputRows);
+  memcpy(interpActiveTiles, tileMask, sizeof(tileMask));
+  interp_kernel(inputFrame_ptr, &tileMask[0], &interpFrameArray[0]);
+#if INTERP_DIRTY_TILES
+  interpRefreshAll = true; // The interpFrameArray no longer match the reference frame
+#endif
+};
+#endif
+
+#if DEBUG_INTERP_BENCH
+#define BENCH_STEPS     64   // Number of sub-pixel positions of the synthetic sliding touch
+#define BENCH_LOOPS     100  // Number of kernel runs per timing
+#define BENCH_THRESHOLD 10   // find_blobs threshold used for the centroid measurement
+
+uint8_t benchArray[RAW_FRAME] = {0};  // 1D Array to store the synthetic raw frame
+image_t benchFrame = {&benchArray[0], RAW_COLS, RAW_ROWS};
+
+// Synthetic gaussian touch centered on posX, posY (raw frame coordinates)
+static void interp_bench_touch(float posX, float posY) {
+  for (uint8_t rowPos = 0; rowPos < RAW_ROWS; rowPos++) {
+    for (uint8_t colPos = 0; colPos < RAW_COLS; colPos++) {
+      float dist = pow(colPos - posX, 2) + pow(rowPos - posY, 2);
+      benchArray[rowPos * RAW_COLS + colPos] = (uint8_t)(120 * expf(-dist / 2.88f)); // sigma = 1.2
+    };
+  };
+};
+
+// Run one kernel on the synthetic frame and return the blob centroid X error
+static float interp_bench_centroid(boolean bicubic, float posX, float posY, image_t* outputFrame_ptr, tracks_t* tracks_ptr) {
+  uint16_t tileMask[RAW_ROWS] = {0};
+  interp_bench_touch(posX, posY);
+  memset((uint8_t*)interpFrameArray, 0, interp.outputCols * interp.outputRows);
+  interp_windowing(&benchFrame, &tileMask[0]);
+  if (bicubic) interp_bicubic<SCALE_X>(&benchFrame, &tileMask[0], &interpFrameArray[0]);
+  else interp_bilinear_fixed<SCALE_X>(&benchFrame, &tileMask[0], &interpFrameArray[0]);
+  BLOB_SETUP(tracks_ptr); // New tracks only: the centroids are not filtered
+  find_blobs(BENCH_THRESHOLD, outputFrame_ptr, &tileMask[0], tracks_ptr);
+  float minError = 255.0f;
+  for (uint64_t live = tracks_ptr->liveMask | tracks_ptr->pendingMask; live; live &= live - 1) { // Not yet confirmed tracks
+    uint8_t id = __builtin_ctzll(live);
+    float error = tracks_ptr->X[id] - posX * SCALE_X;
+    if (fabsf(error) < fabsf(minError)) minError = error;
+  };
+  return minError;
+};
+
+// Compare the bilinear (fixed) and bicubic kernels at the startup scale
+// Timing: full frame interpolation of a single touch
+// Linearity: centroid deviation from the touch position along a sub-pixel sweep (constant offset removed)
+void interp_bench(image_t* outputFrame_ptr, tracks_t* tracks_ptr) {
+  uint16_t tileMask[RAW_ROWS] = {0};
+
+  interp_bench_touch(7.3f, 7.6f);
+  interp_windowing(&benchFrame, &tileMask[0]);
+
+  for (uint8_t kernel = 0; kernel < 2; kernel++) {
+    uint32_t start = micros();
+    for (uint8_t i = 0; i < BENCH_LOOPS; i++) {
+      if (kernel) interp_bicubic<SCALE_X>(&benchFrame, &tileMask[0], &interpFrameArray[0]);
+      else interp_bilinear_fixed<SCALE_X>(&benchFrame, &tileMask[0], &interpFrameArray[0]);
+    };
+    uint32_t duration = micros() - start;
+
+    float error[BENCH_STEPS];
+    float meanError = 0;
+    for (uint8_t step = 0; step < BENCH_STEPS; step++) {
+      error[step] = interp_bench_centroid(kernel, 6.0f + step / (float)(BENCH_STEPS / 2), 7.5f, outputFrame_ptr, tracks_ptr);
+      meanError += error[step];
+    };
+    meanError /= BENCH_STEPS;
+    float maxDev = 0;
+    float meanDev = 0;
+    for (uint8_t step = 0; step < BENCH_STEPS; step++) {
+      float dev = fabsf(error[step] - meanError);
+      if (dev > maxDev) maxDev = dev;
+      meanDev += dev;
+    };
+    meanDev /= BENCH_STEPS;
+    Serial.printf("\nDEBUG_INTERP_BENCH / %s / Time: %dus / Centroid deviation mean: %f max: %f",
+                  kernel ? "BICUBIC" : "BILINEAR", duration / BENCH_LOOPS, meanDev, maxDev);
+  };
+
+#if INTERP_DIRTY_TILES
+  // Resting touch: full refresh, then one cell changed under the touch
+  interp_bench_touch(7.3f, 7.6f);
+  interpRefreshAll = true;
+  uint32_t start = micros();
+  interp_matrix(&benchFrame);
+  uint32_t fullDuration = micros() - start;
+  benchArray[7 * RAW_COLS + 7] += 8;
+  start = micros();
+  interp_matrix(&benchFrame);
+  uint32_t dirtyDuration = micros() - start;
+  Serial.printf("\nDEBUG_INTERP_BENCH / DIRTY_TILES / Dirty tiles: %d of %d / Time: %dus (full refresh %dus)",
+                interpDirtyTiles, (RAW_COLS - 1) * (RAW_ROWS - 1), dirtyDuration, fullDuration);
+#endif
+
+  interp_set_scale(interp.scaleX, outputFrame_ptr); // Clear the arena & force a full refresh
+};
+#endif
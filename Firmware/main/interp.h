@@ -15,12 +15,53 @@ typedef struct image image_t; // forward declaration
 #undef round
 #define round(x) lround(x)
 
+#define INTERP_Q_SHIFT  8                        // Fixed point coefficients format (Q8)
+#define INTERP_Q_ONE    (1 << INTERP_Q_SHIFT)    // 1.0 in Q8
+#define INTERP_Q_HALF   (1 << (INTERP_Q_SHIFT - 1))
+
+#if (SCALE_X != SCALE_Y) || (SCALE_X > MAX_SCALE)
+#error "SCALE_X and SCALE_Y must be the same and not bigger than MAX_SCALE"
+#endif
+
+#define INTERP_R_SHIFT  16                       // Separable kernel output scaling (Q16)
+#define INTERP_R_HALF   (1UL << (INTERP_R_SHIFT - 1))
+
+#define INTERP_C_SHIFT  4                        // Bicubic kernel horizontal pass values format (Q4)
+
+// Dual 16-bit signed multiply with addition of products and 32-bit accumulation
+// sum + x[15:0] * y[15:0] + x[31:16] * y[31:16]
+#if defined(__ARM_FEATURE_DSP) // Cortex-M4 & Cortex-M7 (Teensy 3.x & 4.x)
+#define INTERP_SMLAD(x, y, sum) \
+  ({ \
+    uint32_t _result; \
+    asm ("smlad %0, %1, %2, %3" : "=r" (_result) : "r" ((uint32_t)(x)), "r" ((uint32_t)(y)), "r" ((uint32_t)(sum))); \
+    _result; \
+  })
+#else // Portable fallback
+#define INTERP_SMLAD(x, y, sum) \
+  ({ \
+    uint32_t _x = (x); \
+    uint32_t _y = (y); \
+    (uint32_t)((sum) + (int16_t)_x * (int16_t)_y + (int16_t)(_x >> 16) * (int16_t)(_y >> 16)); \
+  })
+#endif
+
+#define INTERP_TILES_MASK  ((1 << (RAW_COLS - 1)) - 1)  // One bit per interpolated tile in a raw row
+
 extern uint8_t interpThreshold;
+extern uint16_t interpActiveTiles[RAW_ROWS];
+
+#if INTERP_DIRTY_TILES
+extern uint8_t interpNoiseTolerance;
+extern uint8_t interpDirtyTiles;
+#endif
 
 typedef struct interp interp_t;
 struct interp {
   uint8_t   scaleX;
   uint8_t   scaleY;
+  uint8_t   outputCols;
+  uint8_t   outputRows;
   uint16_t  outputStrideY;
   float*    pCoefA;
   float*    pCoefB;
@@ -29,6 +70,18 @@ struct interp {
 };
 
 void INTERP_SETUP(image_t* outputFrame);
+boolean interp_set_scale(uint8_t scale, image_t* outputFrame_ptr);
 void interp_matrix(image_t* inputFrame_ptr);
+#if BLOB_STREAMING
+void interp_active_tiles(image_t* inputFrame_ptr);
+void interp_row(image_t* inputFrame_ptr, uint8_t posY, uint8_t* output_ptr);
+#endif
+#if RAW_BLOBS_PATCH
+void interp_blobs(image_t* inputFrame_ptr, tracks_t* tracks_ptr);
+#endif
+
+#if DEBUG_INTERP_BENCH
+void interp_bench(image_t* outputFrame_ptr, tracks_t* tracks_ptr);
+#endif
 
 #endif /*__INTERP_H__*/
@@ -57,7 +57,7 @@ void llist_extract_node(llist_t* llist_ptr, void* prevData_ptr, void* data_ptr)
     }
     else if (nodeToExtract == llist_ptr->tail_ptr) {
       llist_ptr->tail_ptr = prevNode_ptr;
-      //prevNode_ptr->next_ptr = NULL;
+      prevNode_ptr->next_ptr = NULL;
     }
     else {
       prevNode_ptr->next_ptr = nodeToExtract->next_ptr;
@@ -77,7 +77,12 @@ void llist_swap_llist(llist_t* llistA_ptr, llist_t* llistB_ptr) {
 
 void llist_save_nodes(llist_t* dst_ptr, llist_t* src_ptr) {
   if (src_ptr->head_ptr != NULL) {
-    dst_ptr->tail_ptr->next_ptr = src_ptr->head_ptr;
+    if (dst_ptr->head_ptr != NULL) {
+      dst_ptr->tail_ptr->next_ptr = src_ptr->head_ptr;
+    }
+    else {
+      dst_ptr->head_ptr = src_ptr->head_ptr;
+    }
     dst_ptr->tail_ptr = src_ptr->tail_ptr;
     src_ptr->tail_ptr = src_ptr->head_ptr = NULL;
   }
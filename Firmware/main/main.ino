@@ -8,6 +8,7 @@
 #include "config.h"
 #include "presets.h"
 #include "scan.h"
+#include "source.h"
 #include "interp.h"
 #include "blob.h"
 #include "median.h"
@@ -24,7 +25,7 @@
 
 image_t  rawFrame;      // Input frame values
 image_t  interpFrame;   // Interpolated frame values
-llist_t  blobs;         // Output blobs linked list
+tracks_t tracks;        // Output blobs tracks table
 llist_t  midiIn;        // MidiIn linked list
 
 uint8_t currentMode = CALIBRATE;   // Init currentMode with CALIBRATE (DEFAULT_MODE)
@@ -59,19 +60,40 @@ ccPesets_t ccParam = {NULL, BD, 44, 1, 0};          // ARGS[blobID, [BX,BY,BW,BH
 #endif
 
 void setup() {
-#if DEBUG_ADC || DEBUG_INTERP || DEBUG_BITMAP || DEBUG_BLOBS || DEBUG_FPS || DEBUG_ENCODER || DEBUG_BUTTONS || DEBUG_MAPPING
+#if DEBUG_ADC || DEBUG_INTERP || DEBUG_INTERP_BENCH || DEBUG_BITMAP || DEBUG_BLOB_BENCH || DEBUG_BLOBS || DEBUG_FPS || DEBUG_ENCODER || DEBUG_BUTTONS || DEBUG_MAPPING
   Serial.begin(BAUD_RATE); // Start Serial communication using 230400 baud
   while (!Serial);
   Serial.printf("\n%s_%s", NAME, VERSION);
 #endif
   LEDS_SETUP();
   SWITCHES_SETUP();
+#if FRAME_SOURCE == FRAME_SOURCE_MATRIX
   SPI_SETUP();
   ADC_SETUP();
+#if CELL_GAIN
+  GAIN_SETUP();
+#endif
+#endif
 
-  SCAN_SETUP(&rawFrame);
+  preset_load(&presets[0], &presets[SAVE].update);
+  SOURCE_SETUP(&rawFrame);
+#if FRAME_SOURCE == FRAME_SOURCE_MATRIX
+  if (baseline_load()) {              // Skip the startup calibration
+    currentMode = lastMode;
+    presets[currentMode].setLed = true;
+  }
+#endif
+  INTERP_SETUP(&interpFrame);
+  BLOB_SETUP(&tracks);
+
+#if DEBUG_INTERP_BENCH
+  interp_bench(&interpFrame, &tracks);
+  BLOB_SETUP(&tracks);
+#endif
+#if DEBUG_BLOB_BENCH
+  blob_bench(&interpFrame);
   INTERP_SETUP(&interpFrame);
-  BLOB_SETUP(&blobs);
+#endif
 
 #if USB_MIDI
   USB_MIDI_SETUP();
@@ -91,26 +113,42 @@ void loop() {
   update_presets(&presets[0]);
   update_leds(&presets[0]);
 
-  calibrate_matrix(&presets[0]);
-  scan_matrix();
+#if FRAME_SOURCE == FRAME_SOURCE_MATRIX
+  calibrate_matrix(&presets[0], &tracks);
+#endif
+  if (!read_frame(&rawFrame)) return; // End of the replay file
+
+#if RAW_BLOBS
+  find_raw_blobs(presets[THRESHOLD].val, &rawFrame, &tracks);
+#if RAW_BLOBS_PATCH
+  interp_blobs(&rawFrame, &tracks);
+#endif
+#elif BLOB_STREAMING
+  find_blobs_streaming(presets[THRESHOLD].val, &rawFrame, &interpFrame, &tracks);
+#else
   interp_matrix(&rawFrame);
-  find_blobs(presets[THRESHOLD].val, &interpFrame, &blobs);
+  find_blobs(presets[THRESHOLD].val, &interpFrame, &interpActiveTiles[0], &tracks);
+#endif
+
+  //median(&tracks);
+  //getPolarCoordinates(&tracks);
+  //getBlobsVelocity(&tracks);
 
-  //median(&blobs);
-  //getPolarCoordinates(&blobs);
-  //getBlobsVelocity(&blobs);
+#if BLOB_PREDICTION
+  blobs_predict(&tracks, source_micros());
+#endif
 
 #if USB_MIDI
   if (currentMode == MIDI_LEARN) {
-    usb_midi_learn(&blobs, &presets[MIDI_LEARN]);
+    usb_midi_learn(&tracks, &presets[MIDI_LEARN]);
   }
   else {
-    usb_midi_play(&blobs);
+    usb_midi_play(&tracks);
   };
 #endif
 
 #if USB_SLIP_OSC
-  usb_slipOsc(&presets[0], &rawFrame, &interpFrame, &blobs);
+  usb_slipOsc(&presets[0], &rawFrame, &interpFrame, &tracks);
 #endif
 
 #if HARDWARE_MIDI
@@ -120,13 +158,13 @@ void loop() {
 #endif
 
 #if MAPPING_LAYAOUT
-  gridPlay(&blobs);
-  //controlChange(&blobs, &ccParam);
-  //boolean toggSwitch = toggle(&blobs, &toggParam);
-  //boolean trigSwitch = trigger(&blobs, &trigParam);
-  //hSlider(&blobs, &hSliderParam);
-  //vSlider(&blobs, &vSliderParam);
-  //cSlider(&blobs, &polarCoord[0], &cSlidersParam[0]);
+  gridPlay(&tracks);
+  //controlChange(&tracks, &ccParam);
+  //boolean toggSwitch = toggle(&tracks, &toggParam);
+  //boolean trigSwitch = trigger(&tracks, &trigParam);
+  //hSlider(&tracks, &hSliderParam);
+  //vSlider(&tracks, &vSliderParam);
+  //cSlider(&tracks, &cSlidersParam[0]);
 #endif
 
 #if DEBUG_FPS
@@ -21,17 +21,18 @@ squareKey_t* lastKeyPress_ptr[MAX_SYNTH];       // 1D array to store last keys p
 uint8_t freqKeyLayout[GRID_KEYS] = {0};         // 1D array to mapp freq
 midiNode_t midiKeyLayout[GRID_KEYS] = {0};      // 1D array to mapp incoming midi notes in the grid layout
 
-boolean trigger(llist_t* llist_ptr, tSwitch_t* switch_ptr) {
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(llist_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-    if (blob_ptr->centroid.X > switch_ptr->posX - switch_ptr->rSize &&
-        blob_ptr->centroid.X < switch_ptr->posX + switch_ptr->rSize) {
-      if (blob_ptr->centroid.Y > switch_ptr->posY - switch_ptr->rSize &&
-          blob_ptr->centroid.Y < switch_ptr->posY + switch_ptr->rSize) {
+boolean trigger(tracks_t* tracks_ptr, tSwitch_t* switch_ptr) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    if (tracks_ptr->X[id] > switch_ptr->posX - switch_ptr->rSize &&
+        tracks_ptr->X[id] < switch_ptr->posX + switch_ptr->rSize) {
+      if (tracks_ptr->Y[id] > switch_ptr->posY - switch_ptr->rSize &&
+          tracks_ptr->Y[id] < switch_ptr->posY + switch_ptr->rSize) {
         if (millis() - switch_ptr->timeStamp > SWITCH_DEBOUNCE_TIME) {
           switch_ptr->timeStamp = millis();
           switch_ptr->state = true;
 #if DEBUG_MAPPING
-          Serial.printf("\nDEBUG_TRIGGER : POSX: % f\tPOSY: % f", blob_ptr->centroid.X, blob_ptr->centroid.Y);
+          Serial.printf("\nDEBUG_TRIGGER : POSX: % f\tPOSY: % f", tracks_ptr->X[id], tracks_ptr->Y[id]);
 #endif
           return true;
         };
@@ -44,12 +45,13 @@ boolean trigger(llist_t* llist_ptr, tSwitch_t* switch_ptr) {
   };
 };
 
-boolean toggle(llist_t* llist_ptr, tSwitch_t* switch_ptr) {
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(llist_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-    if (blob_ptr->centroid.X > switch_ptr->posX - switch_ptr->rSize &&
-        blob_ptr->centroid.X < switch_ptr->posX + switch_ptr->rSize) {
-      if (blob_ptr->centroid.Y > switch_ptr->posY - switch_ptr->rSize &&
-          blob_ptr->centroid.Y < switch_ptr->posY + switch_ptr->rSize) {
+boolean toggle(tracks_t* tracks_ptr, tSwitch_t* switch_ptr) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    if (tracks_ptr->X[id] > switch_ptr->posX - switch_ptr->rSize &&
+        tracks_ptr->X[id] < switch_ptr->posX + switch_ptr->rSize) {
+      if (tracks_ptr->Y[id] > switch_ptr->posY - switch_ptr->rSize &&
+          tracks_ptr->Y[id] < switch_ptr->posY + switch_ptr->rSize) {
         if (millis() - switch_ptr->timeStamp > SWITCH_DEBOUNCE_TIME) {
           switch_ptr->timeStamp = millis();
           switch_ptr->state = !switch_ptr->state;
@@ -89,43 +91,44 @@ void GRID_LAYOUT_SETUP(void) {
 /*
   // Compute the grid index location acording to the blobs XY (centroid) coordinates
   // Play corresponding midi **note** or **freq**
-  void gridPlay(llist_t* llist_ptr) {
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(llist_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-    if (blob_ptr->UID < MAX_SYNTH) {                                          // Test if the blob UID is less than MAX_SYNTH
-      int keyPosX = round((blob_ptr->centroid.X / (float)X_MAX) * GRID_COLS); // Compute X window position
-      int keyPosY = round((blob_ptr->centroid.Y / (float)Y_MAX) * GRID_ROWS); // Compute Y window position
+  void gridPlay(tracks_t* tracks_ptr) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    if (id < MAX_SYNTH) {                                          // Test if the blob UID is less than MAX_SYNTH
+      int keyPosX = round((tracks_ptr->X[id] / (float)X_MAX) * GRID_COLS); // Compute X window position
+      int keyPosY = round((tracks_ptr->Y[id] / (float)Y_MAX) * GRID_ROWS); // Compute Y window position
       uint8_t index = keyPosY * GRID_COLS + keyPosX;                          // Compute 1D key index position
       squareKey_t* keyPress_ptr = &keyPos[index];
       // Test if the blob is within the key limits
-      if (blob_ptr->centroid.X > keyPress_ptr->Xmin && blob_ptr->centroid.X < keyPress_ptr->Xmax &&
-          blob_ptr->centroid.Y > keyPress_ptr->Ymin && blob_ptr->centroid.Y < keyPress_ptr->Ymax) {
-        //Serial.printf("\nGRID\tBLOB:%d\tLAST_STATE:%d\tSTATE:%d\tKEY:%d", blob_ptr->UID, blob_ptr->lastState, blob_ptr->state, keyPress_ptr->val);
-        if (keyPress_ptr != lastKeyPress_ptr[blob_ptr->UID]) {
-          if (lastKeyPress_ptr[blob_ptr->UID] != NULL) {
+      if (tracks_ptr->X[id] > keyPress_ptr->Xmin && tracks_ptr->X[id] < keyPress_ptr->Xmax &&
+          tracks_ptr->Y[id] > keyPress_ptr->Ymin && tracks_ptr->Y[id] < keyPress_ptr->Ymax) {
+        //Serial.printf("\nGRID\tBLOB:%d\tLAST_STATE:%d\tSTATE:%d\tKEY:%d", id, TRACK_GET_LAST_STATE(tracks_ptr, id), TRACK_GET_STATE(tracks_ptr, id), keyPress_ptr->val);
+        if (keyPress_ptr != lastKeyPress_ptr[id]) {
+          if (lastKeyPress_ptr[id] != NULL) {
   #if HARDWARE_MIDI
-            MIDI.sendNoteOff(lastKeyPress_ptr[blob_ptr->UID]->val, 0, 1);     // Send NoteOFF (CHANNEL_1)
+            MIDI.sendNoteOff(lastKeyPress_ptr[id]->val, 0, 1);     // Send NoteOFF (CHANNEL_1)
   #endif
   #if DEBUG_MAPPING
-            Serial.printf("\nGRID\tBLOB:%d\t\tKEYUP:%d", blob_ptr->UID, (uint8_t)keyPress_ptr->val);
+            Serial.printf("\nGRID\tBLOB:%d\t\tKEYUP:%d", id, (uint8_t)keyPress_ptr->val);
   #endif
           };
   #if HARDWARE_MIDI
           MIDI.sendNoteOn(keyPress_ptr->val, 127, 1);                       // Send NoteON (CHANNEL_1)
   #endif
   #if DEBUG_MAPPING
-          Serial.printf("\nGRID\tBLOB:%d\t\tKEYDOWN:%d", blob_ptr->UID, (uint8_t)keyPress_ptr->val);
+          Serial.printf("\nGRID\tBLOB:%d\t\tKEYDOWN:%d", id, (uint8_t)keyPress_ptr->val);
   #endif
-          lastKeyPress_ptr[blob_ptr->UID] = keyPress_ptr;                   // Save current keyPress_ptr
+          lastKeyPress_ptr[id] = keyPress_ptr;                   // Save current keyPress_ptr
         };
       };
-      if (!blob_ptr->state && lastKeyPress_ptr[blob_ptr->UID] != NULL) {
+      if (!TRACK_GET_STATE(tracks_ptr, id) && lastKeyPress_ptr[id] != NULL) {
   #if HARDWARE_MIDI
-        //MIDI.sendNoteOff(lastKeyPress_ptr[blob_ptr->UID]->val, 0, 1);       // Send NoteOFF (CHANNEL_1)
+        //MIDI.sendNoteOff(lastKeyPress_ptr[id]->val, 0, 1);       // Send NoteOFF (CHANNEL_1)
   #endif
   #if DEBUG_MAPPING
-        Serial.printf("\nGRID\tBLOB:%d\tKEYUP:%d", blob_ptr->UID, (uint8_t)lastKeyPress_ptr[blob_ptr->UID]->val);
+        Serial.printf("\nGRID\tBLOB:%d\tKEYUP:%d", id, (uint8_t)lastKeyPress_ptr[id]->val);
   #endif
-        lastKeyPress_ptr[blob_ptr->UID] = NULL;
+        lastKeyPress_ptr[id] = NULL;
       };
     };
   };
@@ -135,33 +138,34 @@ void GRID_LAYOUT_SETUP(void) {
 
 // Compute the grid index location acording to the blobs XY (centroid) coordinates
 // Play corresponding midi **note** or **freq**
-void gridPlay(llist_t* llist_ptr) {
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(llist_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-    if (blob_ptr->UID < MAX_SYNTH) {                                          // Test if the blob UID is less than MAX_SYNTH
-      int keyPosX = round((blob_ptr->centroid.X / (float)X_MAX) * GRID_COLS); // Compute X window position
-      int keyPosY = round((blob_ptr->centroid.Y / (float)Y_MAX) * GRID_ROWS); // Compute Y window position
+void gridPlay(tracks_t* tracks_ptr) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    if (id < MAX_SYNTH) {                                          // Test if the blob UID is less than MAX_SYNTH
+      int keyPosX = round((tracks_ptr->X[id] / (float)X_MAX) * GRID_COLS); // Compute X window position
+      int keyPosY = round((tracks_ptr->Y[id] / (float)Y_MAX) * GRID_ROWS); // Compute Y window position
       int index = (keyPosY * GRID_COLS) + keyPosX;                            // Compute 1D key index position
-      //Serial.printf("\nGRID\tBLOB:%d\tSTATE:%d\tLAST_STATE:%d\tKEY:%d", blob_ptr->UID, blob_ptr->state, blob_ptr->lastState, index);
+      //Serial.printf("\nGRID\tBLOB:%d\tSTATE:%d\tLAST_STATE:%d\tKEY:%d", id, TRACK_GET_STATE(tracks_ptr, id), TRACK_GET_LAST_STATE(tracks_ptr, id), index);
       squareKey_t* keyPress_ptr = &keyPos[index];
       // Test if the blob is within the key limits
-      if (blob_ptr->centroid.X > keyPress_ptr->Xmin && blob_ptr->centroid.X < keyPress_ptr->Xmax &&
-          blob_ptr->centroid.Y > keyPress_ptr->Ymin && blob_ptr->centroid.Y < keyPress_ptr->Ymax) {
-        if (blob_ptr->state) {
-          if (!blob_ptr->lastState) {
+      if (tracks_ptr->X[id] > keyPress_ptr->Xmin && tracks_ptr->X[id] < keyPress_ptr->Xmax &&
+          tracks_ptr->Y[id] > keyPress_ptr->Ymin && tracks_ptr->Y[id] < keyPress_ptr->Ymax) {
+        if (TRACK_GET_STATE(tracks_ptr, id)) {
+          if (!TRACK_GET_LAST_STATE(tracks_ptr, id)) {
 #if HARDWARE_MIDI
             //MIDI.sendNoteOn(keyPress_ptr->val, 127, 1);                   // Send NoteON (CHANNEL_1)
 #endif
 #if DEBUG_MAPPING
-            Serial.printf("\nGRID\tBLOB:%d\t\tKEYDOWN:%d", blob_ptr->UID, (uint8_t)keyPress_ptr->val);
+            Serial.printf("\nGRID\tBLOB:%d\t\tKEYDOWN:%d", id, (uint8_t)keyPress_ptr->val);
 #endif
           };
         }
         else {
 #if HARDWARE_MIDI
-          //MIDI.sendNoteOff(lastKeyPress_ptr[blob_ptr->UID]->val, 0, 1);  // Send NoteOFF (CHANNEL_1)
+          //MIDI.sendNoteOff(lastKeyPress_ptr[id]->val, 0, 1);  // Send NoteOFF (CHANNEL_1)
 #endif
 #if DEBUG_MAPPING
-          Serial.printf("\nGRID\tBLOB:%d\t\tKEYUP:%d", blob_ptr->UID, (uint8_t)keyPress_ptr->val);
+          Serial.printf("\nGRID\tBLOB:%d\t\tKEYUP:%d", id, (uint8_t)keyPress_ptr->val);
 #endif
         };
       };
@@ -181,14 +185,15 @@ void gridPopulate(llist_t* llist_ptr) {
   };
 };
 
-void vSlider(llist_t* llist_ptr, vSlider_t* slider_ptr) {
+void vSlider(tracks_t* tracks_ptr, vSlider_t* slider_ptr) {
   uint8_t val = 0;
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(llist_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-    if (blob_ptr->centroid.X > slider_ptr->posX - slider_ptr->width &&
-        blob_ptr->centroid.X < slider_ptr->posX + slider_ptr->width) {
-      if (blob_ptr->centroid.Y > slider_ptr->Ymin &&
-          blob_ptr->centroid.Y < slider_ptr->Ymax) {
-        val = round(map(blob_ptr->centroid.Y, slider_ptr->Ymin, slider_ptr->Ymax, 0, 127)); // [0:127]
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    if (tracks_ptr->X[id] > slider_ptr->posX - slider_ptr->width &&
+        tracks_ptr->X[id] < slider_ptr->posX + slider_ptr->width) {
+      if (tracks_ptr->Y[id] > slider_ptr->Ymin &&
+          tracks_ptr->Y[id] < slider_ptr->Ymax) {
+        val = round(map(tracks_ptr->Y[id], slider_ptr->Ymin, slider_ptr->Ymax, 0, 127)); // [0:127]
         if (val != slider_ptr->val) {
           slider_ptr->val = val;
 #if DEBUG_MAPPING
@@ -200,14 +205,15 @@ void vSlider(llist_t* llist_ptr, vSlider_t* slider_ptr) {
   };
 };
 
-void hSlider(llist_t* llist_ptr, hSlider_t* slider_ptr) {
+void hSlider(tracks_t* tracks_ptr, hSlider_t* slider_ptr) {
   uint8_t val = 0;
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(llist_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-    if (blob_ptr->centroid.Y > slider_ptr->posY - slider_ptr->height &&
-        blob_ptr->centroid.Y < slider_ptr->posY + slider_ptr->height) {
-      if (blob_ptr->centroid.X > slider_ptr->Xmin &&
-          blob_ptr->centroid.X < slider_ptr->Xmax) {
-        val = round(map(blob_ptr->centroid.X, slider_ptr->Xmin, slider_ptr->Xmax, 0, 127)); // [0:127]
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    if (tracks_ptr->Y[id] > slider_ptr->posY - slider_ptr->height &&
+        tracks_ptr->Y[id] < slider_ptr->posY + slider_ptr->height) {
+      if (tracks_ptr->X[id] > slider_ptr->Xmin &&
+          tracks_ptr->X[id] < slider_ptr->Xmax) {
+        val = round(map(tracks_ptr->X[id], slider_ptr->Xmin, slider_ptr->Xmax, 0, 127)); // [0:127]
         if (val != slider_ptr->val) {
           slider_ptr->val = val;
 #if DEBUG_MAPPING
@@ -219,17 +225,18 @@ void hSlider(llist_t* llist_ptr, hSlider_t* slider_ptr) {
   };
 };
 
-void cSlider(llist_t* llist_ptr, polar_t* polar_ptr, cSlider_t* slider_ptr) {
+void cSlider(tracks_t* tracks_ptr, cSlider_t* slider_ptr) {
   float phi = 0;
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(llist_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
     for (int i = 0; i < C_SLIDERS; i++) {
-      if (polar_ptr[blob_ptr->UID].r > slider_ptr[i].r - slider_ptr[i].width &&
-          polar_ptr[blob_ptr->UID].r < slider_ptr[i].r + slider_ptr[i].width) {
-        if (polar_ptr[blob_ptr->UID].phi > slider_ptr[i].phiOffset) {
-          phi = polar_ptr[blob_ptr->UID].phi - slider_ptr[i].phiOffset;
+      if (tracks_ptr->r[id] > slider_ptr[i].r - slider_ptr[i].width &&
+          tracks_ptr->r[id] < slider_ptr[i].r + slider_ptr[i].width) {
+        if (tracks_ptr->phi[id] > slider_ptr[i].phiOffset) {
+          phi = tracks_ptr->phi[id] - slider_ptr[i].phiOffset;
         }
         else {
-          phi = polar_ptr[blob_ptr->UID].phi + (PI2 - slider_ptr[i].phiOffset);
+          phi = tracks_ptr->phi[id] + (PI2 - slider_ptr[i].phiOffset);
         }
 #if DEBUG_MAPPING
         Serial.printf("\nDEBUG_C_SLIDER_ % d phi : % f", i, map(constrain(phi, 0.2, 5.9), 0.2, 5.9, 0, 127));
@@ -13,7 +13,7 @@
 #include "transmit_midi.h"
 #include "notes.h"
 
-typedef struct blob blob_t;         // Forward declaration
+typedef struct tracks tracks_t;     // Forward declaration
 typedef struct llist llist_t;       // Forward declaration
 typedef struct midiNode midiNode_t; // Forward declaration
 
@@ -74,12 +74,12 @@ struct cSlider {
 void GRID_LAYOUT_SETUP(void);
 
 void gridPopulate(llist_t* llist_ptr);
-void gridPlay(llist_t* llist_ptr);
+void gridPlay(tracks_t* tracks_ptr);
 
-boolean trigger(llist_t* llist_ptr, tSwitch_t* switch_ptr);
-boolean toggle(llist_t* llist_ptr, tSwitch_t* switch_ptr);
-void hSlider(llist_t* llist_ptr, hSlider_t* slider_ptr);
-void vSlider(llist_t* llist_ptr, vSlider_t* slider_ptr);
-void cSlider(llist_t* llist_ptr, polar_t* polar_ptr, cSlider_t* slider_ptr);
+boolean trigger(tracks_t* tracks_ptr, tSwitch_t* switch_ptr);
+boolean toggle(tracks_t* tracks_ptr, tSwitch_t* switch_ptr);
+void hSlider(tracks_t* tracks_ptr, hSlider_t* slider_ptr);
+void vSlider(tracks_t* tracks_ptr, vSlider_t* slider_ptr);
+void cSlider(tracks_t* tracks_ptr, cSlider_t* slider_ptr);
 
 #endif /*__MAPPING_H__*/
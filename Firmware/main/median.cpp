@@ -9,53 +9,57 @@
 
 #include "median.h"
 
-median_t blobMedian[MAX_SYNTH] = {0};       // 1D ...
+// The median filter state is stored into the tracks table (zVal, zSort & zIndex)
+void median(tracks_t* tracks_ptr) {
 
-void median(llist_t* blobs_ptr) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    float* zVal = tracks_ptr->zVal[id];
+    uint8_t* zSort = tracks_ptr->zSort[id];
 
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(blobs_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
+    float inputVal = tracks_ptr->D[id]; // The new value
+    float outputVal = inputVal;         // The new value could be the median
 
-    float inputVal = blob_ptr->box.D; // The new value
-    float outputVal = inputVal;       // The new value could be the median
-
-    // Initialize all arrays
-    if (blob_ptr->state && !blob_ptr->lastState) {
-      memset(blobMedian[blob_ptr->UID].zVal, blob_ptr->box.D, MEDIAN_WINDOW * sizeof(uint8_t));
-      memset(blobMedian[blob_ptr->UID].zSort, blob_ptr->box.D, MEDIAN_WINDOW * sizeof(uint8_t));
-      blobMedian[blob_ptr->UID].index = 0;
+    // Initialize all arrays when the track is pressed
+    if (!TRACK_GET_LAST_STATE(tracks_ptr, id)) {
+      for (uint8_t i = 0; i < MEDIAN_WINDOW; i++) {
+        zVal[i] = inputVal;
+        zSort[i] = i;
+      }
+      tracks_ptr->zIndex[id] = 0;
     }
 
     else { // Store new value
-      if (++blobMedian[blob_ptr->UID].index >= MEDIAN_WINDOW) blobMedian[blob_ptr->UID].index = 0; // One step forward in ring storage
+      if (++tracks_ptr->zIndex[id] >= MEDIAN_WINDOW) tracks_ptr->zIndex[id] = 0; // One step forward in ring storage
+      uint8_t zIndex = tracks_ptr->zIndex[id];
 
-      float lastZ = blobMedian[blob_ptr->UID].zVal[blobMedian[blob_ptr->UID].index];       // Save last value
-      uint8_t lastOrdZ = blobMedian[blob_ptr->UID].zSort[blobMedian[blob_ptr->UID].index]; // Save last order
+      uint8_t lastOrdZ = zSort[zIndex];     // Save last order
 
-      blobMedian[blob_ptr->UID].zVal[blobMedian[blob_ptr->UID].index] = blob_ptr->box.D;   // Store new value
-      blobMedian[blob_ptr->UID].zSort[blobMedian[blob_ptr->UID].index] = 0;                // Reset order number for new value
+      zVal[zIndex] = inputVal;              // Store new value
+      zSort[zIndex] = 0;                    // Reset order number for new value
 
-      uint8_t index = blobMedian[blob_ptr->UID].index;                                     // Get index
-      if (++index >= MEDIAN_WINDOW) index = 0;                                             // loop through array storage
+      uint8_t index = zIndex;               // Get index
+      if (++index >= MEDIAN_WINDOW) index = 0; // loop through array storage
 
       do {
-        if (blob_ptr->box.D <= blobMedian[blob_ptr->UID].zVal[index] &&
-            lastOrdZ > blobMedian[blob_ptr->UID].zSort[index]) {
-          blobMedian[blob_ptr->UID].zSort[index]++;     // Remove bigger value, add smaller value
+        if (inputVal <= zVal[index] && lastOrdZ > zSort[index]) {
+          zSort[index]++;                   // Remove bigger value, add smaller value
         }
-        else if (blob_ptr->box.D > blobMedian[blob_ptr->UID].zVal[index] &&
-                 lastOrdZ < blobMedian[blob_ptr->UID].zSort[index]) {
-          blobMedian[blob_ptr->UID].zSort[index]--;                           // Remove smaller value, add bigger value
+        else if (inputVal > zVal[index] && lastOrdZ < zSort[index]) {
+          zSort[index]--;                   // Remove smaller value, add bigger value
         }
-        if (blobMedian[blob_ptr->UID].zSort[index] == MEDIAN_POS) {
-          outputVal = blobMedian[blob_ptr->UID].zVal[index];                  // blobMedian found
+        if (zSort[index] == MEDIAN_POS) {
+          outputVal = zVal[index];          // Median found
         }
-        if (blob_ptr->box.D > blobMedian[blob_ptr->UID].zVal[index]) {
-          blobMedian[blob_ptr->UID].zSort[blobMedian[blob_ptr->UID].index]++; // Compute new value order
+        if (inputVal > zVal[index]) {
+          zSort[zIndex]++;                  // Compute new value order
         }
-        if (++index >= MEDIAN_WINDOW) index = 0;                              // Go one step in ring storage
-      } while (index != blobMedian[blob_ptr->UID].index);                     // Stop at index position
+        if (++index >= MEDIAN_WINDOW) index = 0; // Go one step in ring storage
+      } while (index != zIndex);            // Stop at index position
     }
-    blob_ptr->box.D = outputVal;                                              // Replace the value with the computed blobMedian value
+    tracks_ptr->D[id] = outputVal;          // Replace the value with the computed median value
+#if DEBUG_BLOBS
     Serial.printf("\n%f ; %f", inputVal, outputVal);
+#endif
   }
 }
@@ -14,19 +14,8 @@
 #include "llist.h"
 #include "blob.h"
 
-typedef struct llist llist_t;  // Forward declaration
-typedef struct blob blob_t;    // Forward declaration
+#define MEDIAN_POS ((MEDIAN_WINDOW-1)/2) // position of median in ordered list (MEDIAN_WINDOW is set in blob.h)
 
-#define MEDIAN_WINDOW 5                  // Allowed filter window size : 3, 5, 7...
-#define MEDIAN_POS ((MEDIAN_WINDOW-1)/2) // position of median in ordered list
-
-typedef struct median median_t;
-struct median {
-  float zVal[MEDIAN_WINDOW];  // Input values Array
-  float zSort[MEDIAN_WINDOW]; // Sorted values Array
-  uint8_t index;              // Ring storage current index
-};
-
-void median(llist_t* blobs_ptr);
+void median(tracks_t* tracks_ptr);
 
 #endif /*__MEDIAN_H__*/
@@ -16,6 +16,10 @@
 
 Encoder encoder(ENCODER_PIN_A, ENCODER_PIN_B);
 
+#if !defined(__MK20DX256__) && !defined(__IMXRT1062__)
+uint8_t storageArray[STORAGE_SIZE] = {0};     // In memory EEPROM stand-in (host builds)
+#endif
+
 //Button BUTTON_L = Button();
 Bounce2::Button BUTTON_L = Bounce2::Button();
 //Button BUTTON_R = Button();
@@ -66,6 +70,7 @@ void update_buttons(preset_t* presets_ptr) {
     lastMode = currentMode;
     currentMode = SAVE;
     presets_ptr[SAVE].setLed = true;
+    presets_ptr[SAVE].update = true;
 #if DEBUG_BUTTONS
     Serial.printf("\nBUTTON_L : SAVE : %d", currentMode);
 #endif
@@ -132,6 +137,11 @@ void update_presets(preset_t* presets_ptr) {
         presets_ptr[MIDI_LEARN].update = true;
       }
       break;
+    case SAVE:
+      if (presets_ptr[SAVE].update) {
+        preset_save(presets_ptr, &presets_ptr[SAVE].update);
+      }
+      break;
     default:
       break;
   }
@@ -225,6 +235,7 @@ void update_leds(preset_t* presets_ptr) {
         presets_ptr[CALIBRATE].setLed = false;
         pinMode(LED_PIN_D1, OUTPUT);
         pinMode(LED_PIN_D2, OUTPUT);
+        presets_ptr[CALIBRATE].update = true;  // Start the calibration (done while the LEDs are blinking)
         timeStamp = millis();
         iter = 0;
       }
@@ -240,13 +251,8 @@ void update_leds(preset_t* presets_ptr) {
           digitalWrite(LED_PIN_D2, LOW);
         }
         else if (millis() - timeStamp > CALIBRATE_LED_TIMEON + CALIBRATE_LED_TIMEOFF) {
-          if (iter <= CALIBRATE_LED_ITER) {
-            timeStamp = millis();
-            iter++;
-          }
-          else {
-            presets_ptr[CALIBRATE].update = true;
-          }
+          timeStamp = millis();
+          iter++;
         }
       }
       break;
@@ -305,20 +311,42 @@ boolean setLevel(preset_t* preset_ptr) {
   }
 }
 
-// TODO
-void preset_load(preset_t* preset_ptr, boolean* state_ptr) {
+uint8_t storage_read(uint16_t addr) {
+#if defined(__MK20DX256__) || defined(__IMXRT1062__)
+  return EEPROM.read(addr);
+#else
+  return storageArray[addr];
+#endif
+}
+
+// Only the changed bytes are written (EEPROM wear)
+void storage_write(uint16_t addr, uint8_t val) {
+#if defined(__MK20DX256__) || defined(__IMXRT1062__)
+  EEPROM.update(addr, val);
+#else
+  storageArray[addr] = val;
+#endif
+}
+
+// Load the LINE_OUT, SIG_IN, SIG_OUT & THRESHOLD values saved with the SAVE mode (BUTTON_L long press)
+// Return false if no presets record was saved, the default presets are kept
+boolean preset_load(preset_t* preset_ptr, boolean* state_ptr) {
 
+  *state_ptr = false;
+  if (storage_read(STORAGE_PRESETS_MAGIC) != PRESETS_MAGIC) return false;
   for (int i = 0; i < 4; i++) {
-    // EEPROM.read(i, preset_ptr[i].val); // uint8_t
+    preset_ptr[i].val = constrain(storage_read(STORAGE_PRESETS + i), preset_ptr[i].minVal, preset_ptr[i].maxVal);
+    preset_ptr[i].ledVal = map(preset_ptr[i].val, preset_ptr[i].minVal, preset_ptr[i].maxVal, 0, 255);
   }
-  state_ptr = false;
+  interpThreshold = constrain(preset_ptr[THRESHOLD].val - 5, preset_ptr[THRESHOLD].minVal, preset_ptr[THRESHOLD].maxVal);
+  return true;
 }
 
-// TODO
 void preset_save(preset_t* preset_ptr, boolean* state_ptr) {
 
   for (int i = 0; i < 4; i++) {
-    //EEPROM.write(i, preset_ptr[i].val); // uint8_t
+    storage_write(STORAGE_PRESETS + i, preset_ptr[i].val);
   }
-  state_ptr = false;
+  storage_write(STORAGE_PRESETS_MAGIC, PRESETS_MAGIC);
+  *state_ptr = false;
 }
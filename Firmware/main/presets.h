@@ -13,7 +13,9 @@
 #include <Bounce2.h>                   // https://github.com/thomasfredericks/Bounce2
 #define ENCODER_OPTIMIZE_INTERRUPTS
 #include <Encoder.h>                   // https://github.com/PaulStoffregen/Encoder
-//#include <EEPROM.h>                  // https://www.arduino.cc/en/Reference/EEPROM (TODO)
+#if defined(__MK20DX256__) || defined(__IMXRT1062__)
+#include <EEPROM.h>                    // https://www.arduino.cc/en/Reference/EEPROM
+#endif
 
 typedef struct interp interp_t;        // forward declaration
 
@@ -25,6 +27,12 @@ typedef struct interp interp_t;        // forward declaration
 #define CALIBRATE   5
 #define SAVE        6
 
+#define STORAGE_SIZE        1024       // Used EEPROM bytes (Teensy 4.0 have 1080)
+#define STORAGE_PRESETS     0          // EEPROM address of the presets values
+#define STORAGE_PRESETS_MAGIC 4        // EEPROM address of the presets record marker
+#define PRESETS_MAGIC       0xE2       // Presets record marker (a blank EEPROM keeps the default presets)
+#define STORAGE_BASELINE    16         // EEPROM address of the matrix baseline record
+
 extern uint8_t interpThreshold;
 extern uint8_t currentMode;
 extern uint8_t lastMode;
@@ -49,7 +57,9 @@ void update_presets(preset_t* presets_ptr);
 void update_leds(preset_t* preset_ptr);
 boolean setLevel(preset_t* preset_ptr);
 
-void preset_load(preset_t* preset_ptr, boolean* state_ptr); // TODO
-void preset_save(preset_t* preset_ptr, boolean* state_ptr); // TODO
+uint8_t storage_read(uint16_t addr);
+void storage_write(uint16_t addr, uint8_t val);
+boolean preset_load(preset_t* preset_ptr, boolean* state_ptr);
+void preset_save(preset_t* preset_ptr, boolean* state_ptr);
 
 #endif /*__PRESETS_H__*/
@@ -6,6 +6,8 @@
 
 #include "scan.h"
 
+#if FRAME_SOURCE == FRAME_SOURCE_MATRIX
+
 ADC* adc = new ADC();                    // ADC object
 ADC::Sync_result result;                 // Store ADC_0 & ADC_1
 
@@ -25,14 +27,54 @@ ADC::Sync_result result;                 // Store ADC_0 & ADC_1
 #define ADC1_PIN          A2             // Pin 16 is connected to the output of multiplexerB (SIG pin)
 #endif
 
+#if defined(E256_HOST)                   // Linux host shims (see Firmware/host)
+#define SS1_PIN           0
+#define ADC0_PIN          A3
+#define ADC1_PIN          A2
+#endif
+
 #define DUAL_COLS         (RAW_COLS / 2)
 #define SET_ORIGIN_X      1              // [-1:1] X-axis origine positioning
 #define SET_ORIGIN_Y      1              // [-1:1] Y-axis origine positioning
 
-#define CALIBRATION_CYCLES  10           // 
+#define CALIBRATION_CYCLES  10           // Frames used to find the cells resting values
+#define CALIBRATION_SAVE_BYTES 8         // Changed baseline bytes written to the EEPROM per idle frame
+#define CALIBRATION_SAVE_READS 32        // Baseline bytes compared with the EEPROM per idle frame
 
-uint8_t offsetArray[RAW_FRAME] = {0};    // 1D Array to store E256 smallest values
-uint8_t rawFrameArray[RAW_FRAME] = {0};  // 1D Array to store E256 ofseted analog input values
+#if CELL_GAIN
+#define GAIN_UNITY          8            // Unity gain table, the gains tables are 2^(1/8) apart (x0.5 to x7.3)
+#define GAIN_MIN_PRESS      16           // Smallest reference press value to set a cell gain
+#endif
+
+#if BASELINE_TRACKING
+#define BASELINE_SHIFT      10           // Resting values IIR filter time constant (2^BASELINE_SHIFT frames)
+#if BASELINE_TOUCH_DRIFT
+#define BASELINE_TOUCH_SHIFT 16          // Touched cells resting values IIR filter time constant (objects left on the matrix fade out)
+#endif
+#define NOISE_SHIFT         8            // Noise IIR filter time constant (2^NOISE_SHIFT frames)
+#define NOISE_GAIN          3            // Cells thresholds in mean absolute deviations above the resting values
+#endif
+
+uint8_t offsetArray[RAW_FRAME] = {0};    // 1D Array to store E256 cells thresholds (resting values plus noise)
+#if BASELINE_TRACKING
+uint32_t baselineArray[RAW_FRAME] = {0}; // 1D Array to store E256 cells resting values (Q16)
+uint32_t noiseArray[RAW_FRAME] = {0};    // 1D Array to store E256 cells mean absolute deviation (Q16)
+#endif
+#if CELL_GAIN
+uint8_t gainLut[GAIN_TABLES][256];       // Gains & pressure curve lookup tables
+uint8_t gainArray[RAW_FRAME] = {0};      // 1D Array to store E256 cells gain tables index
+uint8_t gainMaxArray[RAW_FRAME] = {0};   // 1D Array to store the cells max values during the gain calibration
+boolean gainCalibrate = false;           // Gain calibration running
+#endif
+uint8_t calibrateArray[RAW_FRAME] = {0}; // 1D Array to store the cells max values during the calibration
+#if BASELINE_TRACKING
+uint8_t calibrateMinArray[RAW_FRAME] = {0}; // 1D Array to store the cells min values during the calibration
+#endif
+uint8_t calibrateCycles = 0;             // Frames left to the running calibration
+boolean baselineValid = false;           // A baseline was loaded or calibrated, the frames are blank until then
+baseline_t baselineRecord;               // Baseline record as saved in the EEPROM
+uint16_t saveIndex = sizeof(baseline_t); // Next baseline record byte to write in the EEPROM
+static_assert(STORAGE_BASELINE + sizeof(baseline_t) <= STORAGE_SIZE, "The baseline record does not fit in the EEPROM storage");
 
 // Array to store all parameters used to configure the two 8:1 analog multiplexeurs
 // Each byte |ENA|A|B|C|ENA|A|B|C|
@@ -78,73 +120,174 @@ void ADC_SETUP(void) {
   //adc->adc1->setSamplingSpeed(ADC_SAMPLING_SPEED::HIGH_SPEED);          // Change the sampling speed
 };
 
-void SCAN_SETUP(image_t* inputFrame_ptr) {
-  // image_t* rawFrame init config
-  inputFrame_ptr->pData = &rawFrameArray[0];
-  inputFrame_ptr->numCols = RAW_COLS;
-  inputFrame_ptr->numRows = RAW_ROWS;
+// Fletcher-16 checksum of the baseline record
+static uint16_t baseline_checksum(baseline_t* baseline_ptr) {
+  uint16_t sumA = 0;
+  uint16_t sumB = 0;
+  uint8_t* data_ptr = (uint8_t*)baseline_ptr;
+  for (uint16_t i = 0; i < sizeof(baseline_t) - sizeof(uint16_t); i++) {
+    sumA = (sumA + data_ptr[i]) % 255;
+    sumB = (sumB + sumA) % 255;
+  };
+  return (sumB << 8) | sumA;
 };
 
-// Columns are analog INPUT_PINS reded two by two
-// Rows are digital OUTPUT_PINS supplyed one by one sequentially with 3.3V
-void calibrate_matrix(preset_t* presets_ptr) {
+// Set the cells thresholds from the baseline record
+// With BASELINE_TRACKING, the resting values start at the middle of the calibration spread
+// and the noise (mean absolute deviation) at half of it (the calibration frames give a low spread)
+static void baseline_reset(void) {
+  memcpy(&offsetArray[0], &baselineRecord.offset[0], RAW_FRAME);
+  baselineValid = true;
+#if BASELINE_TRACKING
+  for (uint16_t i = 0; i < RAW_FRAME; i++) {
+    uint8_t spread = MIN(baselineRecord.spread[i], baselineRecord.offset[i]);
+    baselineArray[i] = (baselineRecord.offset[i] << 16) - (spread << 15);
+    noiseArray[i] = spread << 15;
+  };
+#endif
+};
 
-  if (presets_ptr[CALIBRATE].update == true) {
-    presets_ptr[CALIBRATE].update = false;
-    uint16_t setRows;
-    for (uint8_t i = 0; i < CALIBRATION_CYCLES; i++) {
-      for (uint8_t col = 0; col < DUAL_COLS; col++) {         // ANNALOG_PINS [0-7] with [8-15]
-#if SET_ORIGIN_Y
-        setRows = 0x1;                                        // Reset to [0000 0000 0000 0001]
+// Return the cell value above its threshold
+// With BASELINE_TRACKING, the resting cells (below their threshold) update their resting value & noise
+// while the touched cells keep their resting value (a held press never fades out)
+// With BASELINE_TOUCH_DRIFT, the touched cells update their resting value, 2^(BASELINE_TOUCH_SHIFT - BASELINE_SHIFT) times slower
+// The threshold is the resting value plus NOISE_GAIN times the noise
+static inline uint8_t cell_value(uint8_t val, uint16_t index) {
+#if BASELINE_TRACKING
+  int32_t dev = (val << 16) - baselineArray[index];
+  if (val <= offsetArray[index]) {
+    baselineArray[index] += (dev + (1 << (BASELINE_SHIFT - 1))) >> BASELINE_SHIFT;
+    noiseArray[index] += ((int32_t)(abs(dev) - noiseArray[index]) + (1 << (NOISE_SHIFT - 1))) >> NOISE_SHIFT;
+  }
+#if BASELINE_TOUCH_DRIFT
+  else {
+    baselineArray[index] += (dev + (1 << (BASELINE_TOUCH_SHIFT - 1))) >> BASELINE_TOUCH_SHIFT;
+  };
+#endif
+  uint32_t threshold = (baselineArray[index] + NOISE_GAIN * noiseArray[index] + (1 << 15)) >> 16;
+  offsetArray[index] = threshold > 255 ? 255 : threshold;
+  return val > offsetArray[index] ? val - offsetArray[index] : 0;
 #else
-        setRows = 0x8000;                                     // Reset to [1000 0000 0000 0000]
-#endif
-        for (uint8_t row = 0; row < RAW_ROWS; row++) {        // DIGITAL_PINS [0-15]
-          digitalWrite(SS1_PIN, LOW);                         // Set the Slave Select Pin LOW
-#if defined(__MK20DX256__)                                    // If using Teensy 3.2
-          //SPI.transfer16(setRows);                          // Set up the two OUTPUT shift registers (FIXME)
-          SPI.transfer((uint8_t)(setRows & 0xFF));            // Shift out one byte to setup one OUTPUT shift register
-          SPI.transfer((uint8_t)((setRows >> 8) & 0xFF));     // Shift out one byte to setup one OUTPUT shift register
-          SPI.transfer(setDualCols[col]);                     // Shift out one byte that setup the two INPUT 8:1 analog multiplexers
-#endif
-#if defined(__IMXRT1062__)                                    // If using Teensy 4.0 & 4.1
-          //SPI1.transfer16(setRows);                         // Set up the two OUTPUT shift registers (FIXME)
-          SPI1.transfer((uint8_t)(setRows & 0xFF));           // Shift out one byte to setup one OUTPUT shift register
-          SPI1.transfer((uint8_t)((setRows >> 8) & 0xFF));    // Shift out one byte to setup one OUTPUT shift register
-          SPI1.transfer(setDualCols[col]);                    // Shift out one byte that setup the two INPUT 8:1 analog multiplexers
-#endif
-          digitalWrite(SS1_PIN, HIGH);                        // Set the Slave Select Pin HIGH
-          uint8_t indexA = row * RAW_COLS + col;              // Compute 1D array indexA
-          uint8_t indexB = indexA + DUAL_COLS;                // Compute 1D array indexB
-
-          //delayMicroseconds(10);
-          pinMode(ADC0_PIN, OUTPUT);
-          pinMode(ADC1_PIN, OUTPUT);
-          digitalWrite(ADC0_PIN, LOW);                        // Set the ADC0 Pin to GND to discharge
-          digitalWrite(ADC1_PIN, LOW);                        // Set the ADC0 Pin to GND to discharge
-          pinMode(ADC0_PIN, INPUT);
-          pinMode(ADC1_PIN, INPUT);
-
-          result = adc->analogSynchronizedRead(ADC0_PIN, ADC1_PIN);
-          uint8_t ADC0_val = result.result_adc0;
-          if (ADC0_val > offsetArray[indexA]) offsetArray[indexA] = ADC0_val;
-          uint8_t ADC1_val = result.result_adc1;
-          if (ADC1_val > offsetArray[indexB]) offsetArray[indexB] = ADC1_val;
-#if SET_ORIGIN_Y
-          setRows = setRows << 1;
+  return val > offsetArray[index] ? val - offsetArray[index] : 0;
+#endif
+};
+
+// Write the baseline record to the EEPROM in the background (see calibrate_matrix())
+static void baseline_save(void) {
+  baselineRecord.magic = BASELINE_MAGIC;
+#if CELL_GAIN
+  memcpy(&baselineRecord.gain[0], &gainArray[0], RAW_FRAME);
+#endif
+  baselineRecord.checksum = baseline_checksum(&baselineRecord);
+  saveIndex = 0;
+};
+
+// Load the saved baseline into offsetArray (and gainArray)
+// Return false if there is no valid record (never calibrated, or saving interrupted by a power-off)
+boolean baseline_load(void) {
+#if CALIBRATION_SAVE
+  uint8_t* data_ptr = (uint8_t*)&baselineRecord;
+  for (uint16_t i = 0; i < sizeof(baseline_t); i++) {
+    data_ptr[i] = storage_read(STORAGE_BASELINE + i);
+  };
+  if (baselineRecord.magic != BASELINE_MAGIC || baselineRecord.checksum != baseline_checksum(&baselineRecord)) {
+    return false;
+  };
+  baseline_reset();
+#if CELL_GAIN
+  memcpy(&gainArray[0], &baselineRecord.gain[0], RAW_FRAME);
+#endif
+  return true;
 #else
-          setRows = setRows >> 1;
+  return false;
 #endif
-        };
-      };
+};
+
+#if CELL_GAIN
+// Build the gains tables : pressure curve (PRESSURE_CURVE exponent) then gain
+// All the cells start with the unity gain
+void GAIN_SETUP(void) {
+  for (uint8_t table = 0; table < GAIN_TABLES; table++) {
+    float gain = powf(2, (table - GAIN_UNITY) / 8.0f);
+    for (uint16_t val = 0; val < 256; val++) {
+      float press = gain * 255 * powf(val / 255.0f, PRESSURE_CURVE) + 0.5f;
+      gainLut[table][val] = press > 255 ? 255 : (uint8_t)press;
     };
   };
+  memset(&gainArray[0], GAIN_UNITY, RAW_FRAME);
+};
+
+// Start collecting the cells max values while the reference press sequence is done on the matrix
+void gain_calibrate_start(void) {
+  memset(&gainMaxArray[0], 0, RAW_FRAME);
+  gainCalibrate = true;
+};
+
+static int compare_uint8(const void* a, const void* b) {
+  return *(uint8_t*)a - *(uint8_t*)b;
+};
+
+// Set the pressed cells gains so their max values match the median of all the pressed cells
+// The cells that was not pressed keep their gain, the gains are saved with the baseline
+void gain_calibrate_end(void) {
+  if (!gainCalibrate) return;
+  gainCalibrate = false;
+  uint8_t pressed[RAW_FRAME];
+  uint16_t count = 0;
+  for (uint16_t i = 0; i < RAW_FRAME; i++) {
+    if (gainMaxArray[i] >= GAIN_MIN_PRESS) pressed[count++] = gainMaxArray[i];
+  };
+  if (count == 0) return;
+  qsort(&pressed[0], count, sizeof(uint8_t), compare_uint8);
+  float reference = pressed[count / 2];
+  for (uint16_t i = 0; i < RAW_FRAME; i++) {
+    if (gainMaxArray[i] < GAIN_MIN_PRESS) continue;
+    int16_t table = GAIN_UNITY + lroundf(8 * log2f(reference / gainMaxArray[i]));
+    gainArray[i] = constrain(table, 0, GAIN_TABLES - 1);
+  };
+  baseline_save();
+};
+#endif
+
+// Start a calibration when requested & write the last baseline to the EEPROM, without blocking the main loop
+// The calibration itself is done by scan_matrix() over the next CALIBRATION_CYCLES frames
+// The baseline is only written while nothing touches the matrix (no live or pending track), a few changed bytes per frame
+// An EEPROM write can stall the loop for tens of ms when the Teensy 4 flash emulation erase a sector
+void calibrate_matrix(preset_t* presets_ptr, tracks_t* tracks_ptr) {
+
+  if (presets_ptr[CALIBRATE].update == true) {
+    presets_ptr[CALIBRATE].update = false;
+    memset(&calibrateArray[0], 0, RAW_FRAME);
+#if BASELINE_TRACKING
+    memset(&calibrateMinArray[0], 255, RAW_FRAME);
+#endif
+    calibrateCycles = CALIBRATION_CYCLES;
+    saveIndex = sizeof(baseline_t);                           // Cancel the saving of the previous baseline
+  };
+#if CALIBRATION_SAVE
+  // The checksum is written last so an interrupted saving is never loaded
+  if (tracks_ptr->liveMask | tracks_ptr->pendingMask) return;
+  uint8_t writes = 0;
+  for (uint8_t i = 0; i < CALIBRATION_SAVE_READS && writes < CALIBRATION_SAVE_BYTES && saveIndex < sizeof(baseline_t); i++) {
+    uint8_t val = ((uint8_t*)&baselineRecord)[saveIndex];
+    if (storage_read(STORAGE_BASELINE + saveIndex) != val) {
+      storage_write(STORAGE_BASELINE + saveIndex, val);
+      writes++;
+    };
+    saveIndex++;
+  };
+#endif
 };
 
 // Columns are analog INPUT_PINS reded two by two
 // Rows are digital OUTPUT_PINS supplyed one by one sequentially with 3.3V
-void scan_matrix(void) {
+// While calibrating, the cells max values are also collected (the frames are still given with the previous baseline)
+// The frames are blank until a baseline is loaded or calibrated (first boot : every resting cell would be pressed)
+// The frame scan time is given by frameTime (FRAME_SOURCE_MATRIX)
+void scan_matrix(image_t* inputFrame_ptr) {
 
+  uint8_t* frame_ptr = inputFrame_ptr->pData;
+  frameTime = micros();
   uint16_t setRows;
   for (uint8_t cols = 0; cols < DUAL_COLS; cols++) {      // ANNALOG_PINS [0-7] with [8-15]
 #if SET_ORIGIN_Y
@@ -180,9 +323,28 @@ void scan_matrix(void) {
 
       result = adc->analogSynchronizedRead(ADC0_PIN, ADC1_PIN);
       uint8_t valA = result.result_adc0;
-      valA > offsetArray[indexA] ? rawFrameArray[indexA] = valA - offsetArray[indexA] : rawFrameArray[indexA] = 0;
       uint8_t valB = result.result_adc1;
-      valB > offsetArray[indexB] ? rawFrameArray[indexB] = valB - offsetArray[indexB] : rawFrameArray[indexB] = 0;
+      uint8_t pressA = cell_value(valA, indexA);
+      uint8_t pressB = cell_value(valB, indexB);
+#if CELL_GAIN
+      frame_ptr[indexA] = gainLut[gainArray[indexA]][pressA];
+      frame_ptr[indexB] = gainLut[gainArray[indexB]][pressB];
+      if (gainCalibrate) {
+        if (gainLut[GAIN_UNITY][pressA] > gainMaxArray[indexA]) gainMaxArray[indexA] = gainLut[GAIN_UNITY][pressA];
+        if (gainLut[GAIN_UNITY][pressB] > gainMaxArray[indexB]) gainMaxArray[indexB] = gainLut[GAIN_UNITY][pressB];
+      };
+#else
+      frame_ptr[indexA] = pressA;
+      frame_ptr[indexB] = pressB;
+#endif
+      if (calibrateCycles) {
+        if (valA > calibrateArray[indexA]) calibrateArray[indexA] = valA;
+        if (valB > calibrateArray[indexB]) calibrateArray[indexB] = valB;
+#if BASELINE_TRACKING
+        if (valA < calibrateMinArray[indexA]) calibrateMinArray[indexA] = valA;
+        if (valB < calibrateMinArray[indexB]) calibrateMinArray[indexB] = valB;
+#endif
+      };
 #if SET_ORIGIN_Y
       setRows = setRows << 1;
 #else
@@ -191,9 +353,24 @@ void scan_matrix(void) {
     };
   };
 
+  if (!baselineValid) {
+    memset(frame_ptr, 0, RAW_FRAME);
+  };
+
+  if (calibrateCycles && --calibrateCycles == 0) {        // Calibration done : use & save the new baseline
+    memcpy(&baselineRecord.offset[0], &calibrateArray[0], RAW_FRAME);
+#if BASELINE_TRACKING
+    for (uint16_t i = 0; i < RAW_FRAME; i++) {
+      baselineRecord.spread[i] = calibrateArray[i] - calibrateMinArray[i];
+    };
+#endif
+    baseline_reset();
+    baseline_save();
+  };
+
 #if DEBUG_ADC
   for (uint8_t posY = 0; posY < RAW_ROWS; posY++) {
-    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(&rawFrameArray[0], posY);
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY);
     for (uint8_t posX = 0; posX < RAW_COLS; posX++) {
       Serial.printf("\t%d", IMAGE_GET_PIXEL_FAST(row_ptr, posX));
     };
@@ -202,3 +379,4 @@ void scan_matrix(void) {
   Serial.printf("\n");
 #endif
 };
+#endif
@@ -13,14 +13,40 @@
 
 typedef struct image image_t;       // Forward declaration
 typedef struct preset preset_t;     // Forward declaration
+typedef struct tracks tracks_t;     // Forward declaration
+
+#if FRAME_SOURCE == FRAME_SOURCE_MATRIX
 
 #include <SPI.h>                    // https://github.com/PaulStoffregen/SPI
 #include <ADC.h>                    // https://github.com/pedvide/ADC
 
+#define BASELINE_MAGIC      0xE257   // Baseline record marker (changed with the record layout)
+#define GAIN_TABLES         32       // Gains lookup tables
+
+typedef struct baseline baseline_t;
+struct baseline {
+  uint16_t magic;
+  uint8_t offset[RAW_FRAME];        // Cells resting values
+#if BASELINE_TRACKING
+  uint8_t spread[RAW_FRAME];        // Cells values spread during the calibration (noise seed)
+#endif
+#if CELL_GAIN
+  uint8_t gain[RAW_FRAME];          // Cells gain tables index
+#endif
+  uint16_t checksum;                // Fletcher-16 of the record
+};
+
 void SPI_SETUP(void);
 void ADC_SETUP(void);
-void SCAN_SETUP(image_t* inputFrame_ptr);
-void calibrate_matrix(preset_t* presets_ptr);
-void scan_matrix(void);
+#if CELL_GAIN
+void GAIN_SETUP(void);
+void gain_calibrate_start(void);
+void gain_calibrate_end(void);
+#endif
+boolean baseline_load(void);
+void calibrate_matrix(preset_t* presets_ptr, tracks_t* tracks_ptr);
+void scan_matrix(image_t* inputFrame_ptr);
+
+#endif
 
 #endif /*__SCAN_H__*/
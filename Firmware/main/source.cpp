@@ -0,0 +1,139 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+#include "source.h"
+#include "crosstalk.h"
+
+#if FRAME_SOURCE == FRAME_SOURCE_MATRIX
+#include "scan.h"
+#endif
+
+#if FRAME_SOURCE == FRAME_SOURCE_REPLAY
+#define REPLAY_FILE         "frames.e256"  // Default recorded frames file path (replayPath)
+#ifndef REPLAY_LOOP
+#define REPLAY_LOOP         1              // [0:1] Restart the replay at the end of the file
+#endif
+#endif
+
+#if FRAME_SOURCE == FRAME_SOURCE_SYNTH
+#define SYNTH_FRAME_TIME    5000           // Synthetic frames period (us)
+#define SYNTH_NOISE         2              // [0:255] Synthetic frames uniform noise amplitude
+#define SYNTH_TOUCHES       3              // Synthetic touches number (synthTouches)
+#endif
+
+uint8_t rawFrameArray[RAW_FRAME] = {0};    // 1D Array to store E256 ofseted analog input values
+uint32_t frameTime = 0;                    // Scan time of the current frame (micros)
+
+#if FRAME_SOURCE == FRAME_SOURCE_REPLAY
+const char* replayPath = REPLAY_FILE;      // Recorded frames file path, can be set before SOURCE_SETUP()
+FILE* replayFile = NULL;                   // NULL once the replay is over
+uint32_t replayOffset = 0;                 // Added to the recorded times to keep the frames clock going forward when the replay restart
+#endif
+
+#if FRAME_SOURCE == FRAME_SOURCE_SYNTH
+synth_touch_t synthTouches[SYNTH_TOUCHES] = {
+  {7.5, 7.5, 5.0, 5.0, 0.31, 0.43, 0.0, 110, 0.8, 0  }, // ARGS[posX, posY, radiusX, radiusY, freqX, freqY, phase, amplitude, sigma, pressPeriod]
+  {7.5, 7.5, 6.0, 3.0, 0.23, 0.17, 1.6, 80,  1.0, 3.0}, // ARGS[posX, posY, radiusX, radiusY, freqX, freqY, phase, amplitude, sigma, pressPeriod]
+  {4.0, 11.0, 2.0, 2.0, 0.5, 0.5,  3.1, 30,  0.7, 1.3}  // ARGS[posX, posY, radiusX, radiusY, freqX, freqY, phase, amplitude, sigma, pressPeriod]
+};
+uint32_t synthFrames = 0;                  // Synthetic frames count
+uint32_t synthSeed = 12345;                // Synthetic noise pseudo random generator state
+#endif
+
+void SOURCE_SETUP(image_t* inputFrame_ptr) {
+  // image_t* rawFrame init config
+  inputFrame_ptr->pData = &rawFrameArray[0];
+  inputFrame_ptr->numCols = RAW_COLS;
+  inputFrame_ptr->numRows = RAW_ROWS;
+#if FRAME_SOURCE == FRAME_SOURCE_REPLAY
+  if (replayFile != NULL) fclose(replayFile);
+  replayFile = fopen(replayPath, "rb");
+  replayOffset = 0;
+#endif
+#if FRAME_SOURCE == FRAME_SOURCE_SYNTH
+  synthFrames = 0;
+  synthSeed = 12345;
+#endif
+};
+
+#if FRAME_SOURCE == FRAME_SOURCE_REPLAY
+// Read the next record of the replay file, the frame scan time is the recorded one
+static boolean replay_frame(image_t* inputFrame_ptr) {
+  if (replayFile == NULL) return false;
+  uint8_t record[REPLAY_RECORD_SIZE];
+  boolean restart = false;
+  boolean found = (fread(record, REPLAY_RECORD_SIZE, 1, replayFile) == 1);
+#if REPLAY_LOOP
+  if (!found) {
+    rewind(replayFile);
+    restart = true;
+    found = (fread(record, REPLAY_RECORD_SIZE, 1, replayFile) == 1);
+  };
+#endif
+  if (!found) {
+    fclose(replayFile);
+    replayFile = NULL;
+    return false;
+  };
+  uint32_t recordTime = record[0] | (record[1] << 8) | (record[2] << 16) | ((uint32_t)record[3] << 24);
+  if (restart) replayOffset = frameTime + 1 - recordTime;
+  frameTime = recordTime + replayOffset;
+  memcpy(inputFrame_ptr->pData, &record[sizeof(uint32_t)], RAW_FRAME);
+  return true;
+};
+#endif
+
+#if FRAME_SOURCE == FRAME_SOURCE_SYNTH
+// Draw the synthTouches gaussian touches at their lissajous path positions, the frames are SYNTH_FRAME_TIME apart
+static void synth_frame(image_t* inputFrame_ptr) {
+  frameTime = synthFrames++ * SYNTH_FRAME_TIME;
+  float time = frameTime * 1e-6f;
+  for (uint8_t posY = 0; posY < RAW_ROWS; posY++) {
+    uint8_t* row_ptr = COMPUTE_IMAGE_ROW_PTR(inputFrame_ptr, posY);
+    for (uint8_t posX = 0; posX < RAW_COLS; posX++) {
+      float val = 0;
+      for (uint8_t i = 0; i < SYNTH_TOUCHES; i++) {
+        synth_touch_t* touch_ptr = &synthTouches[i];
+        if (touch_ptr->pressPeriod > 0 && fmodf(time, touch_ptr->pressPeriod) > touch_ptr->pressPeriod / 2) continue;
+        float cx = touch_ptr->posX + touch_ptr->radiusX * sinf(PI2 * touch_ptr->freqX * time + touch_ptr->phase);
+        float cy = touch_ptr->posY + touch_ptr->radiusY * sinf(PI2 * touch_ptr->freqY * time);
+        float dist = pow(posX - cx, 2) + pow(posY - cy, 2);
+        val += touch_ptr->amplitude * expf(-dist / (2 * touch_ptr->sigma * touch_ptr->sigma));
+      };
+#if SYNTH_NOISE
+      synthSeed = synthSeed * 1103515245 + 12345;
+      val += (synthSeed >> 16) % (SYNTH_NOISE + 1);
+#endif
+      row_ptr[posX] = constrain((int)val, 0, 255);
+    };
+  };
+};
+#endif
+
+// Fill the raw frame from the selected FRAME_SOURCE and set its scan time (frameTime)
+// Return false if no frame is available (end of the replay file)
+boolean read_frame(image_t* inputFrame_ptr) {
+#if FRAME_SOURCE == FRAME_SOURCE_MATRIX
+  scan_matrix(inputFrame_ptr);
+#elif FRAME_SOURCE == FRAME_SOURCE_REPLAY
+  if (!replay_frame(inputFrame_ptr)) return false;
+#else
+  synth_frame(inputFrame_ptr);
+#endif
+#if CROSSTALK
+  crosstalk(inputFrame_ptr);
+#endif
+  return true;
+};
+
+// Time on the frames clock (micros), the replay & synthetic frames are processed as if they were scanned now
+uint32_t source_micros(void) {
+#if FRAME_SOURCE == FRAME_SOURCE_MATRIX
+  return micros();
+#else
+  return frameTime;
+#endif
+};
@@ -0,0 +1,47 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+*/
+
+#ifndef __SOURCE_H__
+#define __SOURCE_H__
+
+#include "config.h"
+#include "blob.h"
+
+#if FRAME_SOURCE == FRAME_SOURCE_REPLAY
+#include <stdio.h>
+#endif
+
+typedef struct image image_t;       // Forward declaration
+
+// Replay file (frames.e256) record: frame scan time (uint32_t micros, little endian) followed by the RAW_FRAME values
+// The values are stored row by row (index = row * RAW_COLS + col), records are back to back with no file header
+#define REPLAY_RECORD_SIZE  (sizeof(uint32_t) + RAW_FRAME)
+
+typedef struct synth_touch synth_touch_t;
+struct synth_touch {
+  float posX;         // Lissajous path center (raw cells)
+  float posY;
+  float radiusX;      // Lissajous path radius (raw cells)
+  float radiusY;
+  float freqX;        // Lissajous path frequencies (Hz)
+  float freqY;
+  float phase;        // Lissajous path phase (radians)
+  float amplitude;    // Gaussian touch peak value
+  float sigma;        // Gaussian touch size (raw cells)
+  float pressPeriod;  // Press & release cycle (seconds, pressed the first half), 0 to stay pressed
+};
+
+extern uint32_t frameTime;
+#if FRAME_SOURCE == FRAME_SOURCE_REPLAY
+extern const char* replayPath;
+extern FILE* replayFile;
+#endif
+
+void SOURCE_SETUP(image_t* inputFrame_ptr);
+boolean read_frame(image_t* inputFrame_ptr);
+uint32_t source_micros(void);
+
+#endif /*__SOURCE_H__*/
@@ -54,29 +54,33 @@ boolean handleMidiInput(llist_t* llist_ptr) {
 };
 
 // Send blobs values using ControlChange MIDI format
-// Send only the last blob that have been added to the sensor surface
+// Send only the last blob that have been added to the sensor surface (the youngest track)
 // Separate blob's values according to the encoder position to allow the mapping into Max4Live
-void usb_midi_learn(llist_t* llist_ptr, preset_t* preset_ptr) {
-  if (llist_ptr->tail_ptr != NULL) {
-    blob_t* tailBlob_ptr = (blob_t*)llist_ptr->tail_ptr;
+void usb_midi_learn(tracks_t* tracks_ptr, preset_t* preset_ptr) {
+  if (tracks_ptr->liveMask) {
+    uint8_t id = __builtin_ctzll(tracks_ptr->liveMask);
+    for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+      uint8_t trackId = __builtin_ctzll(live);
+      if (tracks_ptr->age[trackId] < tracks_ptr->age[id]) id = trackId;
+    }
     switch (preset_ptr->val) {
       case BS:
-        usbMIDI.sendControlChange(BS, tailBlob_ptr->state, tailBlob_ptr->UID + 1);
+        usbMIDI.sendControlChange(BS, TRACK_GET_STATE(tracks_ptr, id), id + 1);
         break;
       case BX:
-        usbMIDI.sendControlChange(BX, (uint8_t)round(map(tailBlob_ptr->centroid.X, 0.0, 59.0, 0, 127)), tailBlob_ptr->UID + 1);
+        usbMIDI.sendControlChange(BX, (uint8_t)round(map(tracks_ptr->X[id], 0.0, 59.0, 0, 127)), id + 1);
         break;
       case BY:
-        usbMIDI.sendControlChange(BY, (uint8_t)round(map(tailBlob_ptr->centroid.Y, 0.0, 59.0, 0, 127)), tailBlob_ptr->UID + 1);
+        usbMIDI.sendControlChange(BY, (uint8_t)round(map(tracks_ptr->Y[id], 0.0, 59.0, 0, 127)), id + 1);
         break;
       case BW:
-        usbMIDI.sendControlChange(BW, tailBlob_ptr->box.W, tailBlob_ptr->UID + 1);
+        usbMIDI.sendControlChange(BW, tracks_ptr->W[id], id + 1);
         break;
       case BH:
-        usbMIDI.sendControlChange(BH, tailBlob_ptr->box.H, tailBlob_ptr->UID + 1);
+        usbMIDI.sendControlChange(BH, tracks_ptr->H[id], id + 1);
         break;
       case BD:
-        usbMIDI.sendControlChange(BD, constrain(tailBlob_ptr->box.D, 0, 127), tailBlob_ptr->UID + 1);
+        usbMIDI.sendControlChange(BD, constrain(tracks_ptr->D[id], 0, 127), id + 1);
         break;
     }
     while (usbMIDI.read()); // Read and discard any incoming MIDI messages
@@ -84,87 +88,89 @@ void usb_midi_learn(llist_t* llist_ptr, preset_t* preset_ptr) {
 }
 
 // Send all blobs values using ControlChange MIDI format
-void usb_midi_play(llist_t* llist_ptr) {
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(llist_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
-    usbMIDI.sendControlChange(BS, blob_ptr->state, blob_ptr->UID + 1);
-    usbMIDI.sendControlChange(BX, (uint8_t)round(map(blob_ptr->centroid.X, 0.0, 59.0, 0, 127)), blob_ptr->UID + 1);
-    usbMIDI.sendControlChange(BY, (uint8_t)round(map(blob_ptr->centroid.Y, 0.0, 59.0, 0, 127)), blob_ptr->UID + 1);
-    usbMIDI.sendControlChange(BW, blob_ptr->box.W, blob_ptr->UID + 1);
-    usbMIDI.sendControlChange(BH, blob_ptr->box.H, blob_ptr->UID + 1);
-    usbMIDI.sendControlChange(BD, constrain(blob_ptr->box.D, 0, 127), blob_ptr->UID + 1);
+void usb_midi_play(tracks_t* tracks_ptr) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
+    usbMIDI.sendControlChange(BS, TRACK_GET_STATE(tracks_ptr, id), id + 1);
+    usbMIDI.sendControlChange(BX, (uint8_t)round(map(tracks_ptr->X[id], 0.0, 59.0, 0, 127)), id + 1);
+    usbMIDI.sendControlChange(BY, (uint8_t)round(map(tracks_ptr->Y[id], 0.0, 59.0, 0, 127)), id + 1);
+    usbMIDI.sendControlChange(BW, tracks_ptr->W[id], id + 1);
+    usbMIDI.sendControlChange(BH, tracks_ptr->H[id], id + 1);
+    usbMIDI.sendControlChange(BD, constrain(tracks_ptr->D[id], 0, 127), id + 1);
   }
   while (usbMIDI.read()); // Read and discard any incoming MIDI messages
 }
 
 // ccPesets_ptr -> ARGS[blobID, [BX,BY,BW,BH,BD], cChange, midiChannel, Val]
-void controlChange(llist_t* llist_ptr, ccPesets_t* ccPesets_ptr) {
-  for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(llist_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
+void controlChange(tracks_t* tracks_ptr, ccPesets_t* ccPesets_ptr) {
+  for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+    uint8_t id = __builtin_ctzll(live);
     // Test if we are within the blob limit
-    if (blob_ptr->UID == ccPesets_ptr->blobID) {
+    if (id == ccPesets_ptr->blobID) {
       // Test if the blob is alive
-      if (blob_ptr->state) {
+      if (TRACK_GET_STATE(tracks_ptr, id)) {
         switch (ccPesets_ptr->mappVal) {
           case BX:
-            if (blob_ptr->centroid.X != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->centroid.X;
-              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(blob_ptr->centroid.X, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->X[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->X[id];
+              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(tracks_ptr->X[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
           case BY:
-            if (blob_ptr->centroid.Y != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->centroid.Y;
-              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(blob_ptr->centroid.Y, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->Y[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->Y[id];
+              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(tracks_ptr->Y[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
           case BW:
-            if (blob_ptr->box.W != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->box.W;
-              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(blob_ptr->box.W, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->W[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->W[id];
+              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(tracks_ptr->W[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
           case BH:
-            if (blob_ptr->box.H != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->box.H;
-              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(blob_ptr->box.H, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->H[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->H[id];
+              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(tracks_ptr->H[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
           case BD:
-            if (blob_ptr->box.D != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->box.D;
-              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(blob_ptr->box.D, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->D[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->D[id];
+              usbMIDI.sendControlChange(ccPesets_ptr->cChange, constrain(tracks_ptr->D[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
         }
 #if DEBUG_MAPPING
         switch (ccPesets_ptr->mappVal) {
           case BX:
-            if (blob_ptr->centroid.X != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->centroid.X;
-              Serial.printf("\nMIDI\tCC:%d\tVAL:%d\tCHAN:%d", blob_ptr->UID, constrain(blob_ptr->centroid.X, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->X[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->X[id];
+              Serial.printf("\nMIDI\tCC:%d\tVAL:%d\tCHAN:%d", id, constrain(tracks_ptr->X[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
           case BY:
-            if (blob_ptr->centroid.Y != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->centroid.Y;
-              Serial.printf("\nMIDI\tCC:%d\tVAL:%d\tCHAN:%d", blob_ptr->UID, constrain(blob_ptr->centroid.Y, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->Y[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->Y[id];
+              Serial.printf("\nMIDI\tCC:%d\tVAL:%d\tCHAN:%d", id, constrain(tracks_ptr->Y[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
           case BW:
-            if (blob_ptr->box.W != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->box.W;
-              Serial.printf("\nMIDI\tCC:%d\tVAL:%d\tCHAN:%d", blob_ptr->UID, constrain(blob_ptr->box.W, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->W[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->W[id];
+              Serial.printf("\nMIDI\tCC:%d\tVAL:%d\tCHAN:%d", id, constrain(tracks_ptr->W[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
           case BH:
-            if (blob_ptr->box.H != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->box.H;
-              Serial.printf("\nMIDI\tCC:%d\tVAL:%d\tCHAN:%d", blob_ptr->UID, constrain(blob_ptr->box.H, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->H[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->H[id];
+              Serial.printf("\nMIDI\tCC:%d\tVAL:%d\tCHAN:%d", id, constrain(tracks_ptr->H[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
           case BD:
-            if (blob_ptr->box.D != ccPesets_ptr->val) {
-              ccPesets_ptr->val = blob_ptr->box.D;
-              Serial.printf("\nBLOB:%d\tCC:%d\tVAL:%d\tCHAN:%d", blob_ptr->UID, ccPesets_ptr->cChange, constrain(blob_ptr->box.D, 0, 127), ccPesets_ptr->midiChannel);
+            if (tracks_ptr->D[id] != ccPesets_ptr->val) {
+              ccPesets_ptr->val = tracks_ptr->D[id];
+              Serial.printf("\nBLOB:%d\tCC:%d\tVAL:%d\tCHAN:%d", id, ccPesets_ptr->cChange, constrain(tracks_ptr->D[id], 0, 127), ccPesets_ptr->midiChannel);
             }
             break;
         }
@@ -14,7 +14,7 @@
 
 typedef struct preset preset_t; // Forward declaration
 typedef struct llist llist_t;   // Forward declaration
-typedef struct blob blob_t;     // Forward declaration
+typedef struct tracks tracks_t; // Forward declaration
 
 #if USB_MIDI || HARDWARE_MIDI
 #include <MIDI.h>               // http://www.pjrc.com/teensy/td_midi.html
@@ -66,15 +66,15 @@ struct ccPesets {
 
 #if USB_MIDI
 void USB_MIDI_SETUP(void);
-void usb_midi_learn(llist_t* llist_ptr, preset_t* preset_ptr);
-void usb_midi_play(llist_t* llist_ptr);
+void usb_midi_learn(tracks_t* tracks_ptr, preset_t* preset_ptr);
+void usb_midi_play(tracks_t* tracks_ptr);
 #endif
 
 #if HARDWARE_MIDI
 void HARDWARE_MIDI_SETUP(void);
 void midi_llist_init(llist_t* midiNodes_ptr, midiNode_t* nodeArray_ptr);
 boolean handleMidiInput(llist_t* llist_ptr);
-void controlChange(llist_t* llist_ptr, ccPesets_t* ccPesets_ptr);
+void controlChange(tracks_t* tracks_ptr, ccPesets_t* ccPesets_ptr);
 #endif
 
 #endif /*__TRANSMIT_MIDI_H__*/
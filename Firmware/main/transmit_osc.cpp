@@ -14,7 +14,7 @@ void USB_SLIP_OSC_SETUP(void) {
   SLIPSerial.begin(BAUD_RATE);
 }
 
-void usb_slipOsc(preset_t* presets_ptr, image_t* rawFrame_ptr, image_t*interpFrame_ptr, llist_t* blobs_ptr) {
+void usb_slipOsc(preset_t* presets_ptr, image_t* rawFrame_ptr, image_t*interpFrame_ptr, tracks_t* tracks_ptr) {
 
   OSCMessage request;
 
@@ -42,6 +42,21 @@ void usb_slipOsc(preset_t* presets_ptr, image_t* rawFrame_ptr, image_t*interpFra
         presets_ptr[THRESHOLD].update = true;
       */
     }
+    else if (request.fullMatch("/s")) { // Set interpolation scale factor [1, 2, 4, 8]
+      if (request.isInt(0)) {
+        int32_t scale = request.getInt(0);
+        if (scale >= 1 && scale <= MAX_SCALE) { // Not narrowed before the range check (260 would give 4)
+          interp_set_scale((uint8_t)scale, interpFrame_ptr); // Not a power of two : rejected
+        }
+      }
+    }
+#if CELL_GAIN && FRAME_SOURCE == FRAME_SOURCE_MATRIX
+    else if (request.fullMatch("/g")) { // Cells gain calibration [1 : start the reference press sequence, 0 : set & save the gains]
+      if (request.isInt(0)) {
+        request.getInt(0) ? gain_calibrate_start() : gain_calibrate_end();
+      }
+    }
+#endif
     else if (request.fullMatch("/r")) { // Get raw datas
       OSCMessage m("/r");
       m.add(rawFrame_ptr->pData, RAW_FRAME);
@@ -50,29 +65,41 @@ void usb_slipOsc(preset_t* presets_ptr, image_t* rawFrame_ptr, image_t*interpFra
       SLIPSerial.endPacket();
     }
     else if (request.fullMatch("/i")) { // Get interp
+#if BLOB_STREAMING
+      interp_matrix(rawFrame_ptr); // The interpolated frame is only computed on request
+#endif
       OSCMessage m("/i");
-      m.add(interpFrame_ptr->pData, NEW_FRAME);
+      m.add(interpFrame_ptr->pData, interpFrame_ptr->numCols * interpFrame_ptr->numRows);
       SLIPSerial.beginPacket();
       m.send(SLIPSerial);
       SLIPSerial.endPacket();
     }
     else if (request.fullMatch("/b")) { // Get blobs
       OSCBundle OSCbundle;
-      for (blob_t* blob_ptr = (blob_t*)ITERATOR_START_FROM_HEAD(blobs_ptr); blob_ptr != NULL; blob_ptr = (blob_t*)ITERATOR_NEXT(blob_ptr)) {
+      for (uint64_t live = tracks_ptr->liveMask; live; live &= live - 1) {
+        uint8_t id = __builtin_ctzll(live);
+        // Packed blob values: UID, state, lastState, X, Y, W, H, D
+        uint8_t blob[OSC_BLOB_SIZE];
+        blob[0] = id;
+        blob[1] = TRACK_GET_STATE(tracks_ptr, id);
+        blob[2] = TRACK_GET_LAST_STATE(tracks_ptr, id);
+        memcpy(&blob[3], &tracks_ptr->X[id], sizeof(float));
+        memcpy(&blob[7], &tracks_ptr->Y[id], sizeof(float));
+        blob[11] = tracks_ptr->W[id];
+        blob[12] = tracks_ptr->H[id];
+        blob[13] = tracks_ptr->D[id];
         OSCMessage msg("/b");
-        /*
-        msg.add(blob_ptr->UID);
-        msg.add(blob_ptr->state);
-        msg.add(blob_ptr->lastState);
-        msg.add(blob_ptr->centroid.X);
-        msg.add(blob_ptr->centroid.Y);
-        msg.add(blob_ptr->box.W);
-        msg.add(blob_ptr->box.H);
-        msg.add(blob_ptr->box.D);
-        */
-        msg.add((uint8_t*)blobs_ptr, 14);
+        msg.add(&blob[0], OSC_BLOB_SIZE);
+        OSCbundle.add(msg);
+      }
+#if BLOB_LINEAGE
+      // Packed merge & split events of the current frame: type, parent UID, child UID
+      for (uint8_t i = 0; i < tracks_ptr->eventCount; i++) {
+        OSCMessage msg("/e");
+        msg.add((uint8_t*)&tracks_ptr->events[i], OSC_EVENT_SIZE);
         OSCbundle.add(msg);
       }
+#endif
       SLIPSerial.beginPacket();     // Send SLIP header
       OSCbundle.send(SLIPSerial);   // Send the OSC bundle
       SLIPSerial.endPacket();       // Send the SLIP end of packet
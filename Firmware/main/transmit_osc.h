@@ -11,6 +11,7 @@
 #include "presets.h"
 #include "llist.h"
 #include "blob.h"
+#include "scan.h"
 
 #include <OSCBoards.h>              // https://github.com/CNMAT/OSC
 #include <OSCMessage.h>             // https://github.com/CNMAT/OSC
@@ -19,17 +20,20 @@
 
 typedef struct preset preset_t;     // Forward declaration
 typedef struct llist llist_t;       // Forward declaration
-typedef struct blob blob_t;         // Forward declaration
+typedef struct tracks tracks_t;     // Forward declaration
+
+#define OSC_BLOB_SIZE   14  // Packed blob values size (bytes)
+#define OSC_EVENT_SIZE  3   // Packed track event values size (bytes)
 
 extern uint8_t currentMode;
 extern uint8_t lastMode;
 
 void USB_SLIP_OSC_SETUP(void);
-void usb_slipOsc(preset_t* presets_ptr, image_t* rawFrame_ptr, image_t*interpFrame_ptr, llist_t* blobs_ptr);
+void usb_slipOsc(preset_t* presets_ptr, image_t* rawFrame_ptr, image_t*interpFrame_ptr, tracks_t* tracks_ptr);
 void set_calibration(preset_t* presets_ptr);
 void set_threshold(preset_t* presets_ptr);
 void get_raw(image_t*interpFrame_ptr);
 void get_interp(image_t*interpFrame_ptr);
-void get_blobs(llist_t* blobs_ptr);
+void get_blobs(tracks_t* tracks_ptr);
 
 #endif /*__TRANSMIT_OSC_H__*/
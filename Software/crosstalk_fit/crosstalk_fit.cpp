@@ -0,0 +1,149 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+
+  Offline fitting of the E256 rows & columns crosstalk coefficients (Firmware/main/crosstalk.cpp)
+
+  Build : g++ -O2 -o crosstalk_fit crosstalk_fit.cpp
+  Usage : ./crosstalk_fit frames.e256 [touchMin] [touchRadius]
+
+  The frames file use the firmware replay format (FRAME_SOURCE_REPLAY) : for each frame,
+  the scan time (uint32_t micros, little endian) followed by the 16x16 raw values.
+  Record it with CROSSTALK set to 0 while pressing the matrix with ONE finger at a time, all over the surface.
+  In each frame with a touch (peak value >= touchMin), the cells farther than touchRadius from the peak
+  only see the ghost pressure, they are used to fit by least squares the firmware model (no bias) :
+    val = rowCoef * (rowSum - val) + colCoef * (colSum - val)
+  The coefficients are printed in Q16, ready to be pasted in crosstalk.cpp.
+  The background RMS is then computed again with the firmware integer compensation and the printed coefficients.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+
+#define RAW_COLS      16
+#define RAW_ROWS      16
+#define RAW_FRAME     (RAW_COLS * RAW_ROWS)
+#define RECORD_SIZE   (sizeof(uint32_t) + RAW_FRAME)
+
+// Touch frames background cells : call back each cell farther than touchRadius from the frame peak
+// Returns the number of frames with a touch
+typedef void (*cell_cb_t)(const uint8_t* frame, const int* rowSum, const int* colSum, int x, int y, void* ctx);
+
+static long for_each_background_cell(FILE* file, int touchMin, int touchRadius, long* frames_ptr, cell_cb_t cell_cb, void* ctx) {
+  uint8_t record[RECORD_SIZE];
+  long touchFrames = 0;
+  *frames_ptr = 0;
+  rewind(file);
+  while (fread(record, RECORD_SIZE, 1, file) == 1) {
+    uint8_t* frame = &record[sizeof(uint32_t)];
+    (*frames_ptr)++;
+
+    int peak = 0;
+    for (int i = 1; i < RAW_FRAME; i++) {
+      if (frame[i] > frame[peak]) peak = i;
+    }
+    if (frame[peak] < touchMin) continue;
+    touchFrames++;
+
+    int rowSum[RAW_ROWS] = {0};
+    int colSum[RAW_COLS] = {0};
+    for (int y = 0; y < RAW_ROWS; y++) {
+      for (int x = 0; x < RAW_COLS; x++) {
+        rowSum[y] += frame[y * RAW_COLS + x];
+        colSum[x] += frame[y * RAW_COLS + x];
+      }
+    }
+
+    int peakX = peak % RAW_COLS;
+    int peakY = peak / RAW_COLS;
+    for (int y = 0; y < RAW_ROWS; y++) {
+      for (int x = 0; x < RAW_COLS; x++) {
+        if (abs(x - peakX) <= touchRadius && abs(y - peakY) <= touchRadius) continue;
+        cell_cb(frame, rowSum, colSum, x, y, ctx);
+      }
+    }
+  }
+  return touchFrames;
+}
+
+// Normal equations of the features [rowSum - val, colSum - val]
+typedef struct {
+  double A[2][2];
+  double b[2];
+} fit_t;
+
+static void fit_cell(const uint8_t* frame, const int* rowSum, const int* colSum, int x, int y, void* ctx) {
+  fit_t* fit = (fit_t*)ctx;
+  double val = frame[y * RAW_COLS + x];
+  double f[2] = {rowSum[y] - val, colSum[x] - val};
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 2; j++) {
+      fit->A[i][j] += f[i] * f[j];
+    }
+    fit->b[i] += f[i] * val;
+  }
+}
+
+// Background cells energy before & after the firmware compensation (crosstalk.cpp, Q16 integer)
+typedef struct {
+  uint32_t rowCoef;
+  uint32_t colCoef;
+  double sumSq;
+  double residualSq;
+  long samples;
+} residual_t;
+
+static void residual_cell(const uint8_t* frame, const int* rowSum, const int* colSum, int x, int y, void* ctx) {
+  residual_t* res = (residual_t*)ctx;
+  uint8_t val = frame[y * RAW_COLS + x];
+  uint32_t ghost = (res->rowCoef * rowSum[y] + res->colCoef * colSum[x] - (res->rowCoef + res->colCoef) * val) >> 16;
+  uint8_t out = val > ghost ? val - ghost : 0;
+  res->sumSq += val * val;
+  res->residualSq += out * out;
+  res->samples++;
+}
+
+int main(int argc, char** argv) {
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s frames.e256 [touchMin] [touchRadius]\n", argv[0]);
+    return 1;
+  }
+  int touchMin = argc > 2 ? atoi(argv[2]) : 40;
+  int touchRadius = argc > 3 ? atoi(argv[3]) : 2;
+
+  FILE* file = fopen(argv[1], "rb");
+  if (file == NULL) {
+    fprintf(stderr, "can't open %s\n", argv[1]);
+    return 1;
+  }
+
+  fit_t fit = {{{0}}, {0}};
+  long frames = 0;
+  long touchFrames = for_each_background_cell(file, touchMin, touchRadius, &frames, fit_cell, &fit);
+
+  // Solve the 2x2 system A * coef = b (Cramer's rule)
+  double det = fit.A[0][0] * fit.A[1][1] - fit.A[0][1] * fit.A[1][0];
+  if (touchFrames == 0 || fabs(det) < 1e-12) {
+    fprintf(stderr, "%ld frames, %ld with a touch : not enough data to fit\n", frames, touchFrames);
+    fclose(file);
+    return 1;
+  }
+  double rowCoef = (fit.b[0] * fit.A[1][1] - fit.A[0][1] * fit.b[1]) / det;
+  double colCoef = (fit.A[0][0] * fit.b[1] - fit.b[0] * fit.A[1][0]) / det;
+
+  residual_t res = {0};
+  res.rowCoef = (uint32_t)fmin(lround(fmax(rowCoef, 0) * 65536), 65535); // Q16
+  res.colCoef = (uint32_t)fmin(lround(fmax(colCoef, 0) * 65536), 65535); // Q16
+  for_each_background_cell(file, touchMin, touchRadius, &frames, residual_cell, &res);
+  fclose(file);
+
+  printf("// %ld frames, %ld with a touch, %ld background cells\n", frames, touchFrames, res.samples);
+  printf("// background RMS %.3f -> %.3f\n", sqrt(res.sumSq / res.samples), sqrt(res.residualSq / res.samples));
+  printf("#define CROSSTALK_ROW_COEF  %u\n", res.rowCoef);
+  printf("#define CROSSTALK_COL_COEF  %u\n", res.colCoef);
+  return 0;
+}
@@ -0,0 +1,131 @@
+/*
+  This file is part of the E256 - eTextile matrix sensor project - http://matrix.eTextile.org
+  Copyright (c) 2014- Maurin Donneaud <maurin@etextile.org>
+  This work is licensed under Creative Commons Attribution-ShareAlike 4.0 International license, see the LICENSE file for details.
+
+  Record the E256 raw frames in the firmware replay format (FRAME_SOURCE_REPLAY, Firmware/main/source.h)
+
+  Build : g++ -O2 -o frames_record frames_record.cpp
+  Usage : ./frames_record /dev/ttyACM0 frames.e256 [frames]
+
+  The E256 must run the USB_SLIP_OSC firmware, the raw frames are polled with the "/r" OSC request.
+  Each record is the frame receive time (uint32_t micros since the recording start, little endian)
+  followed by the 16x16 raw values, row by row (index = row * 16 + col), with no file header.
+  Record with CROSSTALK set to 0 to fit the crosstalk coefficients (Software/crosstalk_fit).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <time.h>
+
+#define RAW_FRAME     256
+#define SLIP_END      0xC0
+#define SLIP_ESC      0xDB
+#define SLIP_ESC_END  0xDC
+#define SLIP_ESC_ESC  0xDD
+#define PACKET_SIZE   1024
+#define REPLY_SIZE    (4 + 4 + 4 + RAW_FRAME) // "/r" address, ",b" type tag, blob size, raw values
+
+static uint64_t now_us(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static int serial_open(const char* path) {
+  int fd = open(path, O_RDWR | O_NOCTTY);
+  if (fd < 0) return -1;
+  struct termios tty;
+  if (tcgetattr(fd, &tty) != 0) {
+    close(fd);
+    return -1;
+  }
+  cfmakeraw(&tty);
+  cfsetispeed(&tty, B230400);
+  cfsetospeed(&tty, B230400);
+  tty.c_cc[VMIN] = 0;
+  tty.c_cc[VTIME] = 10;   // Read timeout (1/10 s)
+  tcsetattr(fd, TCSANOW, &tty);
+  tcflush(fd, TCIOFLUSH);
+  return fd;
+}
+
+// SLIP encoded "/r" OSC message without arguments
+static bool send_request(int fd) {
+  const uint8_t request[] = {SLIP_END, '/', 'r', 0, 0, ',', 0, 0, 0, SLIP_END};
+  return write(fd, request, sizeof(request)) == sizeof(request);
+}
+
+// Read one SLIP packet, return its size or -1 on timeout
+static int read_packet(int fd, uint8_t* packet) {
+  int size = 0;
+  bool escape = false;
+  uint8_t byte;
+  while (read(fd, &byte, 1) == 1) {
+    if (byte == SLIP_END) {
+      if (size > 0) return size;
+      continue;
+    }
+    if (escape) {
+      byte = (byte == SLIP_ESC_END) ? SLIP_END : (byte == SLIP_ESC_ESC) ? SLIP_ESC : byte;
+      escape = false;
+    }
+    else if (byte == SLIP_ESC) {
+      escape = true;
+      continue;
+    }
+    if (size < PACKET_SIZE) packet[size++] = byte;
+  }
+  return -1;
+}
+
+int main(int argc, char** argv) {
+
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s /dev/ttyACM0 frames.e256 [frames]\n", argv[0]);
+    return 1;
+  }
+  long maxFrames = argc > 3 ? atol(argv[3]) : -1;
+
+  int fd = serial_open(argv[1]);
+  if (fd < 0) {
+    fprintf(stderr, "can't open %s\n", argv[1]);
+    return 1;
+  }
+  FILE* file = fopen(argv[2], "wb");
+  if (file == NULL) {
+    fprintf(stderr, "can't create %s\n", argv[2]);
+    return 1;
+  }
+
+  const uint8_t header[] = {'/', 'r', 0, 0, ',', 'b', 0, 0, 0, 0, (RAW_FRAME >> 8) & 0xFF, RAW_FRAME & 0xFF};
+  uint8_t packet[PACKET_SIZE];
+  uint64_t startTime = now_us();
+  long frames = 0;
+  long errors = 0;
+
+  while (maxFrames < 0 || frames < maxFrames) {
+    if (!send_request(fd)) break;
+    int size = read_packet(fd, packet);
+    if (size != REPLY_SIZE || memcmp(packet, header, sizeof(header)) != 0) {
+      errors++;
+      continue;
+    }
+    uint32_t time = (uint32_t)(now_us() - startTime);
+    uint8_t record[4] = {(uint8_t)time, (uint8_t)(time >> 8), (uint8_t)(time >> 16), (uint8_t)(time >> 24)};
+    fwrite(record, sizeof(record), 1, file);
+    fwrite(&packet[sizeof(header)], RAW_FRAME, 1, file);
+    frames++;
+    if (frames % 1000 == 0) fprintf(stderr, "\r%ld frames", frames);
+  }
+
+  fclose(file);
+  close(fd);
+  fprintf(stderr, "\r%ld frames recorded, %ld bad replies\n", frames, errors);
+  return 0;
+}